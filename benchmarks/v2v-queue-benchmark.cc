@@ -0,0 +1,250 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+// Microbenchmark of the V2V face queue bookkeeping: std::list (old ItemQueue) vs PooledList.
+//
+// Not an ns-3 scenario (it replaces the global operator new to count heap allocations), so it is
+// kept out of scenarios/ and is not built by waf.  It only needs pooled-list.h and boost:
+//
+//     g++ -O2 -Iextensions benchmarks/v2v-queue-benchmark.cc -o v2v-queue-benchmark
+//
+// Emulates the queue workload of 1000 cars with the same rules as V2vNetDeviceFace: new packets
+// are refused when the primary or the low-priority queue holds MaxPacketsInQueue items, every
+// transmitted item goes to the (unbounded) retx queue until MaxRetransmissionAttempts is reached,
+// retx items return to the low-priority queue, and overheard names cancel items from the middle
+// of the queues.  Both variants keep the per-name index as a hash map entry that lives while the
+// name is queued, as the face does.
+//
+// What is NOT measured: packets, tags and Ptr reference counting, the simulator events, and the
+// cost of finding an item to cancel (the face gets it from the index, here it is picked at random)
+
+#include "pooled-list.h"
+
+#include <boost/unordered_map.hpp>
+
+#include <list>
+#include <vector>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+#include <new>
+
+static unsigned long long g_allocations = 0;
+
+void *
+operator new (std::size_t size)
+{
+  g_allocations ++;
+  void *p = std::malloc (size);
+  if (p == 0)
+    throw std::bad_alloc ();
+  return p;
+}
+
+void
+operator delete (void *p) throw ()
+{
+  std::free (p);
+}
+
+// the same size as V2vNetDeviceFace::Item (Time, Ptr<Packet>, name id, type, retx count, links)
+struct BenchItem
+{
+  BenchItem () : m_gap (0), m_packet (0), m_nameId (0), m_type (0), m_retxCount (0), m_prev (0), m_next (0) { }
+
+  long long m_gap;
+  void *m_packet;
+  unsigned int m_nameId;
+  unsigned int m_type;
+  unsigned int m_retxCount;
+  unsigned int m_prev;
+  unsigned int m_next;
+};
+
+static const unsigned int CARS = 1000;
+static const unsigned int MAX_PACKETS_IN_QUEUE = 100;
+static const unsigned int MAX_RETX_ATTEMPTS = 7;
+static const unsigned int STEPS = 20000000;
+
+enum
+  {
+    PRIMARY = 0,
+    LOW_PRIORITY,
+    RETX
+  };
+
+static void
+ReserveOnFirstUse (std::list<BenchItem> &queue)
+{
+}
+
+static void
+ReserveOnFirstUse (ns3::ndn::PooledList<BenchItem> &queue)
+{
+  // the same as V2vNetDeviceFace::Enqueue
+  if (queue.capacity () == 0)
+    queue.reserve (MAX_PACKETS_IN_QUEUE);
+}
+
+/**
+ * \brief Queue rules shared by both variants, Queue is the container of BenchItem
+ */
+template<class Queue>
+struct Car
+{
+  Queue m_queues[3];
+  boost::unordered_map<unsigned int, unsigned int> m_index; // name id -> number of queued items
+
+  bool
+  Push (unsigned int queue, const BenchItem &item)
+  {
+    if (m_queues[PRIMARY].size () >= MAX_PACKETS_IN_QUEUE ||
+        m_queues[LOW_PRIORITY].size () >= MAX_PACKETS_IN_QUEUE)
+      return false;
+
+    Append (queue, item);
+    return true;
+  }
+
+  void
+  Send (unsigned int queue)
+  {
+    BenchItem item = m_queues[queue].front ();
+    PopFront (queue);
+
+    if (queue == RETX)
+      {
+        Append (LOW_PRIORITY, item);
+      }
+    else if (item.m_retxCount < MAX_RETX_ATTEMPTS)
+      {
+        item.m_retxCount ++;
+        Append (RETX, item);
+      }
+  }
+
+  void
+  Append (unsigned int queue, const BenchItem &item)
+  {
+    ReserveOnFirstUse (m_queues[queue]);
+    m_queues[queue].push_back (item);
+    m_index[item.m_nameId] ++;
+  }
+
+  void
+  Release (unsigned int nameId)
+  {
+    boost::unordered_map<unsigned int, unsigned int>::iterator i = m_index.find (nameId);
+    if (-- i->second == 0)
+      m_index.erase (i);
+  }
+
+  void
+  PopFront (unsigned int queue)
+  {
+    Release (m_queues[queue].front ().m_nameId);
+    m_queues[queue].pop_front ();
+  }
+};
+
+struct StdListCar : public Car<std::list<BenchItem> >
+{
+  void
+  Cancel (unsigned int queue, unsigned int position)
+  {
+    std::list<BenchItem>::iterator i = m_queues[queue].begin ();
+    std::advance (i, position);
+    Release (i->m_nameId);
+    m_queues[queue].erase (i);
+  }
+};
+
+struct PooledListCar : public Car<ns3::ndn::PooledList<BenchItem> >
+{
+  void
+  Cancel (unsigned int queue, unsigned int position)
+  {
+    // walk to the item the same way as std::list does
+    ns3::ndn::PooledList<BenchItem>::handle i = m_queues[queue].begin ();
+    for (; position > 0; position--)
+      i = m_queues[queue].next (i);
+    Release (m_queues[queue][i].m_nameId);
+    m_queues[queue].erase (i);
+  }
+};
+
+template<class BenchCar>
+static void
+Run (const char *label)
+{
+  std::srand (1);
+
+  unsigned long long allocationsBefore = g_allocations;
+  std::vector<BenchCar> cars (CARS);
+  unsigned long long setupAllocations = g_allocations - allocationsBefore;
+
+  std::clock_t start = std::clock ();
+  allocationsBefore = g_allocations;
+
+  unsigned long long indexSize = 0;
+  for (unsigned int step = 0; step < STEPS; step++)
+    {
+      BenchCar &car = cars[std::rand () % CARS];
+      unsigned int queue = std::rand () % 3;
+      unsigned int size = car.m_queues[queue].size ();
+
+      unsigned int action = std::rand () % 3;
+      if (action == 0 && queue != RETX)
+        {
+          BenchItem item;
+          item.m_nameId = step;
+          car.Push (queue, item);
+        }
+      else if (action == 1 && size > 0)
+        {
+          car.Send (queue);
+        }
+      else if (action == 2 && size > 0)
+        {
+          car.Cancel (queue, std::rand () % size);
+        }
+    }
+
+  double seconds = static_cast<double> (std::clock () - start) / CLOCKS_PER_SEC;
+  unsigned long long workloadAllocations = g_allocations - allocationsBefore;
+
+  for (unsigned int i = 0; i < CARS; i++)
+    indexSize += cars[i].m_index.size ();
+
+  std::printf ("%-12s setup allocations: %10llu   workload allocations: %10llu   index entries at the end: %8llu   time: %6.2f s\n",
+               label, setupAllocations, workloadAllocations, indexSize, seconds);
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::printf ("%u cars, %u steps, primary and low-priority queues admit new packets up to %u items, retx queue unbounded\n",
+               CARS, STEPS, MAX_PACKETS_IN_QUEUE);
+
+  Run<StdListCar> ("std::list");
+  Run<PooledListCar> ("PooledList");
+
+  return 0;
+}
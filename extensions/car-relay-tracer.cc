@@ -23,6 +23,7 @@
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
 #include "ns3/mobility-model.h"
+#include "ns3/abort.h"
 
 #include "ns3/ndn-l3-protocol.h"
 #include "ns3/ndn-content-store.h"
@@ -31,9 +32,17 @@
 #include "ns3/ndn-interest.h"
 #include "ns3/ndn-content-object.h"
 
+#include "ndn-v2v-net-device-face.h"
+#include "v2v-packet-info-tag.h"
+#include "geo-tag.h"
+#include "v2v-trace-stream.h"
+
 #include <fstream>
+#include <sstream>
+#include <cmath>
 #include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/functional/hash.hpp>
 
 NS_LOG_COMPONENT_DEFINE ("CarRelayTracer");
 
@@ -44,58 +53,197 @@ namespace ns3 {
 namespace ndn {
 
 boost::tuple< boost::shared_ptr<std::ostream>, std::list<boost::shared_ptr<CarRelayTracer> > >
-CarRelayTracer::InstallAll (const std::string &file, int types)
+CarRelayTracer::InstallAll (const std::string &file, int types, bool binary)
 {
-  std::list<boost::shared_ptr<CarRelayTracer> > tracers;
-  boost::shared_ptr<std::ofstream> outputStream (new std::ofstream ());
-  outputStream->open (file.c_str (), std::ios_base::out | std::ios_base::trunc);
+  Output output = OpenOutput (file, types, binary);
+  if (!output.m_os)
+    return boost::make_tuple (output.m_os, std::list<boost::shared_ptr<CarRelayTracer> > ());
+
+  boost::shared_ptr<Sinks> sinks = boost::make_shared<Sinks> ();
+  if (types & DISTANCE_WAITING)
+    sinks->m_distance = output;
+
+  if (types & JUMP_DISTANCE)
+    sinks->m_jumpDistance = output;
+
+  if (types & TX)
+    sinks->m_tx = output;
+
+  if (types & IN_CACHE)
+    sinks->m_inCache = output;
+
+  return boost::make_tuple (output.m_os, Install (sinks));
+}
+
+boost::tuple< boost::shared_ptr<CarRelayTracer::Sinks>, std::list<boost::shared_ptr<CarRelayTracer> > >
+CarRelayTracer::InstallAll (const std::string &prefix, const std::string &suffix, int types, bool binary)
+{
+  std::string extension = V2vTraceStream::GetExtension (binary);
+
+  boost::shared_ptr<Sinks> sinks = boost::make_shared<Sinks> ();
+  if (types & DISTANCE_WAITING)
+    sinks->m_distance = OpenOutput (prefix + "distance" + extension + suffix, DISTANCE_WAITING, binary);
+
+  if (types & JUMP_DISTANCE)
+    sinks->m_jumpDistance = OpenOutput (prefix + "jump-distance" + extension + suffix, JUMP_DISTANCE, binary);
+
+  if (types & TX)
+    sinks->m_tx = OpenOutput (prefix + "tx" + extension + suffix, TX, binary);
+
+  if (types & IN_CACHE)
+    sinks->m_inCache = OpenOutput (prefix + "in-cache" + extension + suffix, IN_CACHE, binary);
+
+  return boost::make_tuple (sinks, Install (sinks));
+}
+
+boost::tuple< boost::shared_ptr<CarRelayTracer::Summary>, std::list<boost::shared_ptr<CarRelayTracer> > >
+CarRelayTracer::InstallSummary (const std::string &prefix, const std::string &suffix, double jumpDistanceBin)
+{
+  boost::shared_ptr<Sinks> sinks = boost::make_shared<Sinks> ();
+  sinks->m_summary = boost::make_shared<Summary> (prefix, suffix, jumpDistanceBin);
+
+  return boost::make_tuple (sinks->m_summary, Install (sinks));
+}
 
-  if (!outputStream->is_open ())
-    return boost::make_tuple (outputStream, tracers);
+std::list<boost::shared_ptr<CarRelayTracer> >
+CarRelayTracer::Install (boost::shared_ptr<Sinks> sinks)
+{
+  if (sinks->m_front == 0)
+    {
+      sinks->m_front = CreateObject<V2vPropagationFront> ();
+    }
 
+  std::list<boost::shared_ptr<CarRelayTracer> > tracers;
   for (NodeList::Iterator node = NodeList::Begin ();
        node != NodeList::End ();
        node++)
     {
-      NS_LOG_DEBUG ("Node: " << lexical_cast<string> ((*node)->GetId ()));
+      NS_LOG_DEBUG ("Node: " << (*node)->GetId ());
 
-      boost::shared_ptr<CarRelayTracer> trace = make_shared<CarRelayTracer> (outputStream, *node);
-      if (types & DISTANCE_WAITING)
-        trace->ConnectDistance ();
+      boost::shared_ptr<CarRelayTracer> trace = boost::make_shared<CarRelayTracer> (sinks, *node);
+      trace->Connect ();
+      tracers.push_back (trace);
+    }
 
-      if (types & JUMP_DISTANCE)
-        trace->ConnectJumpDistance ();
+  return tracers;
+}
 
-      if (types & TX)
-        trace->ConnectTx ();
+CarRelayTracer::Output
+CarRelayTracer::OpenOutput (const std::string &file, int types, bool binary)
+{
+  Output output;
+  output.m_os = V2vTraceStream::Open (file, binary);
+  if (!output.m_os)
+    return output;
 
-      if (types & IN_CACHE)
-        trace->ConnectInCache ();
+  if (binary)
+    {
+      output.m_writer = boost::make_shared<V2vTraceWriter> (output.m_os);
+      output.m_columns = CreateColumns (*output.m_writer, types);
+      output.m_writer->StartBackgroundThread ();
+      return output;
+    }
 
-      tracers.push_back (trace);
+  if ((types & (types - 1)) != 0) // more than one type in the same trace
+    {
+      output.m_text = boost::make_shared<TextColumns> ();
+      output.m_columns = CreateColumns (*output.m_text, types);
+
+      for (uint32_t i = 0; i < output.m_text->m_names.size (); i++)
+        {
+          *output.m_os << (i > 0 ? "\t" : "") << output.m_text->m_names[i];
+        }
+      *output.m_os << "\n";
+      return output;
     }
 
-  if (!tracers.empty ())
+  if (types & DISTANCE_WAITING)
+    *output.m_os << "Time\tType\tJumpDistance\tWaiting\n";
+
+  if (types & JUMP_DISTANCE)
+    *output.m_os << "Time\tNodeId\tJumpDistance\tItem\tFront\n";
+
+  if (types & TX)
+    *output.m_os << "Time\tNodeId\tX\tY\tZ\n";
+
+  if (types & IN_CACHE)
+    *output.m_os << "Time\tNodeId\tX\tY\tZ\n";
+
+  return output;
+}
+
+// the same formatting as of the single-type text traces
+static std::string
+FormatValue (double value)
+{
+  std::ostringstream os;
+  os << value;
+  return os.str ();
+}
+
+uint32_t
+CarRelayTracer::TextColumns::AddColumn (const std::string &name, V2vTraceWriter::ColumnType)
+{
+  m_names.push_back (name);
+  return m_names.size () - 1;
+}
+
+void
+CarRelayTracer::TextColumns::AddLabel (uint32_t, uint32_t value, const std::string &label)
+{
+  m_labels[value] = label;
+}
+
+template<class Writer>
+CarRelayTracer::BinaryColumns
+CarRelayTracer::CreateColumns (Writer &writer, int types)
+{
+  BinaryColumns columns;
+  columns.m_time = writer.AddColumn ("Time", V2vTraceWriter::TIME);
+
+  columns.m_event = V2vTraceWriter::NO_COLUMN;
+  if ((types & (types - 1)) != 0) // more than one type in the same trace
     {
-      if (types & DISTANCE_WAITING)
-        *outputStream << "Time\tType\tJumpDistance\tWaiting\n";
+      columns.m_event = writer.AddColumn ("Type", V2vTraceWriter::UINT8);
+      writer.AddLabel (columns.m_event, DISTANCE_WAITING, "DistanceWaiting");
+      writer.AddLabel (columns.m_event, JUMP_DISTANCE, "JumpDistance");
+      writer.AddLabel (columns.m_event, TX, "Tx");
+      writer.AddLabel (columns.m_event, IN_CACHE, "InCache");
+    }
+
+  columns.m_node = V2vTraceWriter::NO_COLUMN;
+  if (types & (JUMP_DISTANCE | TX | IN_CACHE))
+    columns.m_node = writer.AddColumn ("NodeId", V2vTraceWriter::UINT32);
+
+  columns.m_x = columns.m_y = columns.m_z = V2vTraceWriter::NO_COLUMN;
+  if (types & (TX | IN_CACHE))
+    {
+      columns.m_x = writer.AddColumn ("X", V2vTraceWriter::FLOAT32);
+      columns.m_y = writer.AddColumn ("Y", V2vTraceWriter::FLOAT32);
+      columns.m_z = writer.AddColumn ("Z", V2vTraceWriter::FLOAT32);
+    }
 
-      if (types & JUMP_DISTANCE)
-        *outputStream << "Time\tNodeId\tJumpDistance\n";
+  columns.m_jumpDistance = V2vTraceWriter::NO_COLUMN;
+  if (types & (DISTANCE_WAITING | JUMP_DISTANCE))
+    columns.m_jumpDistance = writer.AddColumn ("JumpDistance", V2vTraceWriter::FLOAT64);
 
-      if (types & TX)
-        *outputStream << "Time\tNodeId\tX\tY\tZ\n";
+  columns.m_waiting = V2vTraceWriter::NO_COLUMN;
+  if (types & DISTANCE_WAITING)
+    columns.m_waiting = writer.AddColumn ("Waiting", V2vTraceWriter::FLOAT64);
 
-      if (types & IN_CACHE)
-        *outputStream << "Time\tNodeId\tX\tY\tZ\n";
+  columns.m_item = columns.m_front = V2vTraceWriter::NO_COLUMN;
+  if (types & JUMP_DISTANCE)
+    {
+      columns.m_item = writer.AddColumn ("Item", V2vTraceWriter::UINT32);
+      columns.m_front = writer.AddColumn ("Front", V2vTraceWriter::FLOAT64);
     }
 
-  return boost::make_tuple (outputStream, tracers);
+  return columns;
 }
 
-CarRelayTracer::CarRelayTracer (boost::shared_ptr<std::ostream> os, Ptr<Node> node)
+CarRelayTracer::CarRelayTracer (boost::shared_ptr<Sinks> sinks, Ptr<Node> node)
   : m_nodePtr (node)
-  , m_os (os)
+  , m_sinks (sinks)
 {
   m_node = boost::lexical_cast<string> (m_nodePtr->GetId ());
 
@@ -107,70 +255,336 @@ CarRelayTracer::CarRelayTracer (boost::shared_ptr<std::ostream> os, Ptr<Node> no
 }
 
 void
-CarRelayTracer::ConnectDistance ()
+CarRelayTracer::Connect ()
 {
+  bool distance = static_cast<bool> (m_sinks->m_distance.m_os);
+  bool jumpDistance = m_sinks->m_jumpDistance.m_os || m_sinks->m_summary;
+  bool tx = m_sinks->m_tx.m_os || m_sinks->m_summary;
+  bool inCache = m_sinks->m_inCache.m_os || m_sinks->m_summary;
+
   Ptr<L3Protocol> ndn = m_nodePtr->GetObject<L3Protocol> ();
   for (uint32_t faceId = 0; faceId < ndn->GetNFaces (); faceId++)
     {
-      ndn->GetFace (faceId)->TraceConnectWithoutContext ("WaitingTimeVsDistanceDataTrace", MakeCallback (&CarRelayTracer::DistanceVsWaiting, this));
+      // only V2V faces have these trace sources
+      Ptr<V2vNetDeviceFace> face = DynamicCast<V2vNetDeviceFace> (ndn->GetFace (faceId));
+      if (face == 0)
+        continue;
+
+      if (distance)
+        face->TraceConnectWithoutContext ("WaitingTimeVsDistanceDataTrace", MakeCallback (&CarRelayTracer::DistanceVsWaiting, this));
+
+      if (jumpDistance)
+        face->TraceConnectWithoutContext ("JumpDistanceData", MakeCallback (&CarRelayTracer::JumpDistance, this));
+
+      if (tx)
+        face->TraceConnectWithoutContext ("TxData", MakeCallback (&CarRelayTracer::Tx, this));
     }
+
+  if (inCache)
+    m_nodePtr->GetObject<ContentStore> ()->TraceConnectWithoutContext ("DidAddEntry", MakeCallback (&CarRelayTracer::InCache, this));
 }
 
+
 void
-CarRelayTracer::ConnectJumpDistance ()
+CarRelayTracer::WriteRecord (const Output &output, int event, std::map<uint32_t, std::string> &fields)
 {
-  Ptr<L3Protocol> ndn = m_nodePtr->GetObject<L3Protocol> ();
-  for (uint32_t faceId = 0; faceId < ndn->GetNFaces (); faceId++)
+  fields[output.m_columns.m_time] = FormatValue (Simulator::Now ().ToDouble (Time::S));
+  fields[output.m_columns.m_event] = output.m_text->m_labels[event];
+
+  for (uint32_t i = 0; i < output.m_text->m_names.size (); i++)
     {
-      ndn->GetFace (faceId)->TraceConnectWithoutContext ("JumpDistanceData", MakeCallback (&CarRelayTracer::JumpDistance, this));
+      std::map<uint32_t, std::string>::const_iterator field = fields.find (i);
+      *output.m_os << (i > 0 ? "\t" : "") << (field != fields.end () ? field->second : "NA");
     }
+  *output.m_os << "\n";
 }
 
 void
-CarRelayTracer::ConnectTx ()
+CarRelayTracer::DistanceVsWaiting (double distance, double waiting)
 {
-  Ptr<L3Protocol> ndn = m_nodePtr->GetObject<L3Protocol> ();
-  for (uint32_t faceId = 0; faceId < ndn->GetNFaces (); faceId++)
+  const Output &output = m_sinks->m_distance;
+  if (output.m_text)
     {
-      ndn->GetFace (faceId)->TraceConnectWithoutContext ("TxData", MakeCallback (&CarRelayTracer::Tx, this));
+      std::map<uint32_t, std::string> fields;
+      fields[output.m_columns.m_jumpDistance] = FormatValue (distance);
+      fields[output.m_columns.m_waiting] = FormatValue (waiting);
+      WriteRecord (output, DISTANCE_WAITING, fields);
+      return;
     }
+
+  if (output.m_writer)
+    {
+      output.m_writer->SetTime (output.m_columns.m_time, Simulator::Now ());
+      output.m_writer->SetInteger (output.m_columns.m_event, DISTANCE_WAITING);
+      output.m_writer->SetDouble (output.m_columns.m_jumpDistance, distance);
+      output.m_writer->SetDouble (output.m_columns.m_waiting, waiting);
+      output.m_writer->Commit ();
+      return;
+    }
+
+  *output.m_os << Simulator::Now ().ToDouble (Time::S) << "\t" << distance << "\t" << waiting << "\n";
 }
 
 void
-CarRelayTracer::ConnectInCache ()
+CarRelayTracer::JumpDistance (Ptr<const Node> node, double jumpDistance, Ptr<const Packet> packet)
 {
-  m_nodePtr->GetObject<ContentStore> ()->TraceConnectWithoutContext ("DidAddEntry", MakeCallback (&CarRelayTracer::InCache, this));
+  // trace is fired only for packets with GeoTransmissionTag
+  GeoTransmissionTag tag;
+  packet->PeekPacketTag (tag);
+
+  // fronts are measured from the data source, if known, the same way in all MPI ranks
+  GeoSrcTag srcTag;
+  bool isSrcTag = packet->PeekPacketTag (srcTag);
+
+  uint32_t nameId = V2vPacketInfoTag::Get (packet).GetNameId ();
+  Vector position = m_nodePtr->GetObject<MobilityModel> ()->GetPosition ();
+  bool advanced = m_sinks->m_front->Update (nameId, isSrcTag ? srcTag.GetPosition () : tag.GetPosition (), position);
+
+  uint32_t item = 0;
+  double front = 0;
+  if (advanced)
+    {
+      item = GetItemKey (packet);
+      front = m_sinks->m_front->GetOffset (nameId, position);
+    }
+
+  if (m_sinks->m_summary)
+    {
+      m_sinks->m_summary->JumpDistance (node->GetId (), jumpDistance, advanced, item, front);
+    }
+
+  const Output &output = m_sinks->m_jumpDistance;
+  if (!output.m_os || !advanced)
+    return;
+
+  if (output.m_text)
+    {
+      std::map<uint32_t, std::string> fields;
+      fields[output.m_columns.m_node] = m_node;
+      fields[output.m_columns.m_jumpDistance] = FormatValue (jumpDistance);
+      fields[output.m_columns.m_item] = lexical_cast<string> (item);
+      fields[output.m_columns.m_front] = FormatValue (front);
+      WriteRecord (output, JUMP_DISTANCE, fields);
+      return;
+    }
+
+  if (output.m_writer)
+    {
+      output.m_writer->SetTime (output.m_columns.m_time, Simulator::Now ());
+      output.m_writer->SetInteger (output.m_columns.m_event, JUMP_DISTANCE);
+      output.m_writer->SetInteger (output.m_columns.m_node, m_nodePtr->GetId ());
+      output.m_writer->SetDouble (output.m_columns.m_jumpDistance, jumpDistance);
+      output.m_writer->SetInteger (output.m_columns.m_item, item);
+      output.m_writer->SetDouble (output.m_columns.m_front, front);
+      output.m_writer->Commit ();
+      return;
+    }
+
+  *output.m_os << Simulator::Now ().ToDouble (Time::S) << "\t" << m_node << "\t" << jumpDistance << "\t" << item << "\t" << front << "\n";
+}
+
+uint32_t
+CarRelayTracer::GetItemKey (Ptr<const Packet> packet)
+{
+  return GetItemKey (*V2vPacketInfoTag::Get (packet).GetName ());
 }
 
+uint32_t
+CarRelayTracer::GetItemKey (const Name &name)
+{
+  return static_cast<uint32_t> (boost::hash_value (boost::lexical_cast<std::string> (name)));
+}
 
 void
-CarRelayTracer::DistanceVsWaiting (double distance, double waiting)
+CarRelayTracer::Tx (Ptr<Node> node, Ptr<const Packet>, const Vector &pos)
 {
-  *m_os << Simulator::Now ().ToDouble (Time::S) << "\t" << distance << "\t" << waiting << "\n";
+  if (m_sinks->m_summary)
+    {
+      m_sinks->m_summary->Tx (m_nodePtr->GetId ());
+    }
+
+  const Output &output = m_sinks->m_tx;
+  if (output.m_writer || output.m_text)
+    {
+      WritePosition (output, TX, pos);
+    }
+  else if (output.m_os)
+    {
+      *output.m_os << Simulator::Now ().ToDouble (Time::S) << "\t" << m_node << "\t" << pos.x << "\t" << pos.y << "\t" << pos.z << "\n";
+    }
 }
 
 void
-CarRelayTracer::JumpDistance (Ptr<const Node> node, double jumpDistance)
+CarRelayTracer::InCache (Ptr<const ndn::cs::Entry> entry)
 {
-  static int s_jumpDistanceLastNode = -1;
-  if (static_cast<int32_t> (node->GetId ()) > s_jumpDistanceLastNode)
+  Vector pos = m_nodePtr->GetObject<MobilityModel> ()->GetPosition ();
+  if (m_sinks->m_summary)
+    {
+      m_sinks->m_summary->InCache (m_nodePtr->GetId (), GetItemKey (entry->GetName ()), pos);
+    }
+
+  const Output &output = m_sinks->m_inCache;
+  if (output.m_writer || output.m_text)
+    {
+      WritePosition (output, IN_CACHE, pos);
+    }
+  else if (output.m_os)
     {
-      s_jumpDistanceLastNode = node->GetId ();
-      *m_os << Simulator::Now ().ToDouble (Time::S) << "\t" << m_node << "\t" << jumpDistance << "\n";
+      *output.m_os << Simulator::Now ().ToDouble (Time::S) << "\t" << m_node << "\t" << pos.x << "\t" << pos.y << "\t" << pos.z << "\n";
     }
 }
 
 void
-CarRelayTracer::Tx (Ptr<Node> node, Ptr<const Packet>, const Vector &pos)
+CarRelayTracer::WritePosition (const Output &output, int event, const Vector &pos)
+{
+  if (output.m_text)
+    {
+      std::map<uint32_t, std::string> fields;
+      fields[output.m_columns.m_node] = m_node;
+      fields[output.m_columns.m_x] = FormatValue (pos.x);
+      fields[output.m_columns.m_y] = FormatValue (pos.y);
+      fields[output.m_columns.m_z] = FormatValue (pos.z);
+      WriteRecord (output, event, fields);
+      return;
+    }
+
+  V2vTraceWriter &writer = *output.m_writer;
+  writer.SetTime (output.m_columns.m_time, Simulator::Now ());
+  writer.SetInteger (output.m_columns.m_event, event);
+  writer.SetInteger (output.m_columns.m_node, m_nodePtr->GetId ());
+  writer.SetDouble (output.m_columns.m_x, pos.x);
+  writer.SetDouble (output.m_columns.m_y, pos.y);
+  writer.SetDouble (output.m_columns.m_z, pos.z);
+  writer.Commit ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+CarRelayTracer::Summary::Summary (const std::string &prefix, const std::string &suffix, double jumpDistanceBin)
+  : m_prefix (prefix)
+  , m_suffix (suffix)
+  , m_jumpDistanceBin (jumpDistanceBin)
 {
-  *m_os << Simulator::Now ().ToDouble (Time::S) << "\t" << m_node << "\t" << pos.x << "\t" << pos.y << "\t" << pos.z << "\n";
 }
 
 void
-CarRelayTracer::InCache (Ptr<const ndn::cs::Entry> entry)
+CarRelayTracer::Summary::Tx (uint32_t node)
 {
-  Vector pos = m_nodePtr->GetObject<MobilityModel> ()->GetPosition ();
-  *m_os << Simulator::Now ().ToDouble (Time::S) << "\t" << m_node << "\t" << pos.x << "\t" << pos.y << "\t" << pos.z << "\n";
+  m_txCounts[node] ++;
+}
+
+void
+CarRelayTracer::Summary::JumpDistance (uint32_t node, double jumpDistance, bool frontAdvanced, uint32_t item, double front)
+{
+  m_jumpDistances[static_cast<int64_t> (std::floor (jumpDistance / m_jumpDistanceBin))] ++;
+
+  if (frontAdvanced)
+    {
+      FrontPoint point;
+      point.m_time = Simulator::Now ();
+      point.m_node = node;
+      point.m_jumpDistance = jumpDistance;
+      point.m_item = item;
+      point.m_front = front;
+      m_front.push_back (point);
+    }
+}
+
+void
+CarRelayTracer::Summary::InCache (uint32_t node, uint32_t item, const Vector &pos)
+{
+  std::pair<uint32_t, uint32_t> key (node, item);
+  if (m_inCache.find (key) != m_inCache.end ())
+    return;
+
+  Arrival arrival;
+  arrival.m_time = Simulator::Now ();
+  arrival.m_position = pos;
+  m_inCache.insert (std::make_pair (key, arrival));
+}
+
+static boost::shared_ptr<std::ostream>
+OpenSummary (const std::string &file)
+{
+  boost::shared_ptr<std::ostream> os = V2vTraceStream::Open (file);
+  if (!os)
+    {
+      NS_LOG_ERROR ("Cannot open " << file << " for writing");
+    }
+  return os;
+}
+
+void
+CarRelayTracer::Summary::Write () const
+{
+  std::string extension = V2vTraceStream::GetExtension ();
+
+  std::map<uint32_t, uint32_t> histogram;
+  for (std::map<uint32_t, uint32_t>::const_iterator i = m_txCounts.begin (); i != m_txCounts.end (); i++)
+    {
+      histogram[i->second] ++;
+    }
+
+  boost::shared_ptr<std::ostream> txCounts = OpenSummary (m_prefix + "tx-counts" + extension + m_suffix);
+  if (txCounts)
+    {
+      *txCounts << "NodeId\tCount\n";
+      for (std::map<uint32_t, uint32_t>::const_iterator i = m_txCounts.begin (); i != m_txCounts.end (); i++)
+        {
+          *txCounts << i->first << "\t" << i->second << "\n";
+        }
+    }
+
+  boost::shared_ptr<std::ostream> txHistogram = OpenSummary (m_prefix + "tx-histogram" + extension + m_suffix);
+  if (txHistogram)
+    {
+      *txHistogram << "Count\tNumberOfCars\n";
+      for (std::map<uint32_t, uint32_t>::const_iterator i = histogram.begin (); i != histogram.end (); i++)
+        {
+          *txHistogram << i->first << "\t" << i->second << "\n";
+        }
+    }
+
+  boost::shared_ptr<std::ostream> front = OpenSummary (m_prefix + "jump-distance" + extension + m_suffix);
+  if (front)
+    {
+      *front << "Time\tNodeId\tJumpDistance\tItem\tFront\n";
+      for (std::vector<FrontPoint>::const_iterator i = m_front.begin (); i != m_front.end (); i++)
+        {
+          *front << i->m_time.ToDouble (Time::S) << "\t" << i->m_node << "\t" << i->m_jumpDistance
+                 << "\t" << i->m_item << "\t" << i->m_front << "\n";
+        }
+    }
+
+  boost::shared_ptr<std::ostream> jumpDistances = OpenSummary (m_prefix + "jump-distance-histogram" + extension + m_suffix);
+  if (jumpDistances)
+    {
+      *jumpDistances << "JumpDistance\tCount\n";
+      for (std::map<int64_t, uint32_t>::const_iterator i = m_jumpDistances.begin (); i != m_jumpDistances.end (); i++)
+        {
+          *jumpDistances << i->first * m_jumpDistanceBin << "\t" << i->second << "\n";
+        }
+    }
+
+  boost::shared_ptr<std::ostream> inCache = OpenSummary (m_prefix + "in-cache" + extension + m_suffix);
+  if (inCache)
+    {
+      // ordered by arrival time, as the IN_CACHE trace
+      typedef std::map<std::pair<uint32_t, uint32_t>, Arrival>::const_iterator arrival_iterator;
+      std::multimap<Time, arrival_iterator> arrivals;
+      for (arrival_iterator i = m_inCache.begin (); i != m_inCache.end (); i++)
+        {
+          arrivals.insert (std::make_pair (i->second.m_time, i));
+        }
+
+      *inCache << "Time\tNodeId\tX\tY\tZ\tItem\n";
+      for (std::multimap<Time, arrival_iterator>::const_iterator i = arrivals.begin (); i != arrivals.end (); i++)
+        {
+          const Vector &pos = i->second->second.m_position;
+          *inCache << i->first.ToDouble (Time::S) << "\t" << i->second->first.first << "\t" << pos.x << "\t" << pos.y << "\t" << pos.z
+                   << "\t" << i->second->first.second << "\n";
+        }
+    }
 }
 
 } // namespace ndn
@@ -27,7 +27,12 @@
 #include <ns3/ndn-content-store.h>
 #include <ns3/vector.h>
 
+#include "v2v-trace-writer.h"
+#include "v2v-propagation-front.h"
+
 #include <iostream>
+#include <map>
+#include <vector>
 
 namespace ns3 {
 namespace ndn {
@@ -47,52 +52,246 @@ public:
    * @brief Helper method to install tracers on all simulation nodes
    *
    * @param file File to which traces will be written
-   * @param types any ORed combination of DISTANCE_WAITING, JUMP_DISTANCE, TX, and IN_CACHE
+   * @param types any ORed combination of DISTANCE_WAITING, JUMP_DISTANCE, TX, and IN_CACHE.  With several
+   *              types, the trace has a single header and a Type column (see TextColumns)
+   * @param binary write binary columnar trace (see V2vTraceWriter) instead of text; binary records are
+   *               packed and written by a separate thread
    *
    * @returns a tuple of reference to output stream and list of tracers. !!! Attention !!! This tuple needs to be preserved
    *          for the lifetime of simulation, otherwise SEGFAULTs are inevitable
    *
    */
   static boost::tuple< boost::shared_ptr<std::ostream>, std::list<boost::shared_ptr<CarRelayTracer> > >
-  InstallAll (const std::string &file, int types);
+  InstallAll (const std::string &file, int types, bool binary = false);
+
+  class Summary;
+  struct Sinks;
+
+  /**
+   * @brief Helper method to install tracers on all simulation nodes, writing each type of the trace into its own file
+   *
+   * Every trace source is connected only once, events are dispatched to the file of their type:
+   * <prefix>distance, <prefix>jump-distance, <prefix>tx, and <prefix>in-cache (plus extension and suffix)
+   *
+   * @param prefix prefix of the output files
+   * @param suffix suffix of the output files (e.g., MPI rank)
+   * @param types any ORed combination of DISTANCE_WAITING, JUMP_DISTANCE, TX, and IN_CACHE
+   * @param binary write binary columnar traces instead of text
+   *
+   * @returns a tuple of the sinks and list of tracers, which needs to be preserved for the lifetime of simulation
+   */
+  static boost::tuple< boost::shared_ptr<Sinks>, std::list<boost::shared_ptr<CarRelayTracer> > >
+  InstallAll (const std::string &prefix, const std::string &suffix, int types, bool binary = false);
+
+  /**
+   * @brief In-memory aggregation of the traces of all nodes
+   *
+   * Instead of writing every event, keeps only what the figure scripts use and writes the
+   * summaries when Write is called (after Simulator::Run):
+   * - <prefix>tx-counts.txt: number of data transmissions per node (NodeId, Count)
+   * - <prefix>tx-histogram.txt: number of nodes that transmitted data given number of times (Count, NumberOfCars)
+   * - <prefix>jump-distance.txt: propagation front, the same as JUMP_DISTANCE trace (Time, NodeId, JumpDistance, Item, Front)
+   * - <prefix>jump-distance-histogram.txt: distribution of all data jump distances (JumpDistance, Count),
+   *   JumpDistance is the lower bound of the bin
+   * - <prefix>in-cache.txt: first arrival of each data item to the cache of each node, the same as IN_CACHE
+   *   trace when nodes cache every item only once (Time, NodeId, X, Y, Z, Item)
+   */
+  class Summary
+  {
+  public:
+    Summary (const std::string &prefix, const std::string &suffix, double jumpDistanceBin);
+
+    void
+    Tx (uint32_t node);
+
+    /**
+     * @param frontAdvanced whether the reception advanced the propagation front of the data (see V2vPropagationFront)
+     * @param item  key of the data name (see GetItemKey), used only if the front advanced
+     * @param front signed distance from the origin of the data to the node, used only if the front advanced
+     */
+    void
+    JumpDistance (uint32_t node, double jumpDistance, bool frontAdvanced, uint32_t item, double front);
+
+    /**
+     * @param item key of the data name (see GetItemKey)
+     */
+    void
+    InCache (uint32_t node, uint32_t item, const Vector &pos);
 
+    /**
+     * @brief Write all summaries (files that cannot be opened are skipped with an error message)
+     */
+    void
+    Write () const;
+
+  private:
+    std::string m_prefix;
+    std::string m_suffix;
+    double m_jumpDistanceBin;
+
+    std::map<uint32_t, uint32_t> m_txCounts;
+
+    struct FrontPoint
+    {
+      Time m_time;
+      uint32_t m_node;
+      double m_jumpDistance;
+      uint32_t m_item;
+      double m_front;
+    };
+    std::vector<FrontPoint> m_front;
+
+    std::map<int64_t, uint32_t> m_jumpDistances;
+
+    struct Arrival
+    {
+      Time m_time;
+      Vector m_position;
+    };
+    std::map<std::pair<uint32_t, uint32_t>, Arrival> m_inCache; ///< \brief first arrivals by node and item
+  };
+
+  /**
+   * @brief Helper method to install tracers that aggregate traces of all nodes in memory (see Summary)
+   *
+   * @param prefix prefix of the output files
+   * @param suffix suffix of the output files (e.g., MPI rank)
+   * @param jumpDistanceBin bin width of the jump distance histogram
+   *
+   * @returns a tuple of summary and list of tracers, which needs to be preserved for the lifetime of simulation.
+   *          Summaries are written by Summary::Write
+   */
+  static boost::tuple< boost::shared_ptr<Summary>, std::list<boost::shared_ptr<CarRelayTracer> > >
+  InstallSummary (const std::string &prefix, const std::string &suffix = "", double jumpDistanceBin = 10.0);
+
+  /**
+   * @brief Indexes of the binary trace columns (V2vTraceWriter::NO_COLUMN if column is not present)
+   */
+  struct BinaryColumns
+  {
+    uint32_t m_time;
+    uint32_t m_event;
+    uint32_t m_node;
+    uint32_t m_x;
+    uint32_t m_y;
+    uint32_t m_z;
+    uint32_t m_jumpDistance;
+    uint32_t m_waiting;
+    uint32_t m_item;
+    uint32_t m_front;
+  };
+
+  /**
+   * @brief Columns of the text trace with several event types, the same as of the binary trace
+   *
+   * Such trace has a single header, every record has all the columns (NA if the event does not have the value)
+   */
+  struct TextColumns
+  {
+    uint32_t
+    AddColumn (const std::string &name, V2vTraceWriter::ColumnType type);
+
+    void
+    AddLabel (uint32_t column, uint32_t value, const std::string &label);
+
+    std::vector<std::string> m_names;
+    std::map<uint32_t, std::string> m_labels; ///< @brief names of the event types
+  };
+
+  /**
+   * @brief Text or binary trace file
+   */
+  struct Output
+  {
+    boost::shared_ptr<std::ostream> m_os;
+    boost::shared_ptr<V2vTraceWriter> m_writer; ///< @brief set for the binary trace
+    boost::shared_ptr<TextColumns> m_text; ///< @brief set for the text trace with several event types
+    BinaryColumns m_columns;
+  };
+
+  /**
+   * @brief Destinations of the events, shared by tracers of all nodes
+   *
+   * Several event types may share the same output.  Events are also passed to the summary, if present.
+   * JUMP_DISTANCE events are written only when they advance the propagation front of the data
+   * (per data name and direction).
+   */
+  struct Sinks
+  {
+    Output m_distance;
+    Output m_jumpDistance;
+    Output m_tx;
+    Output m_inCache;
+    boost::shared_ptr<Summary> m_summary;
+    Ptr<V2vPropagationFront> m_front;
+  };
+
+  /**
+   * @brief Install tracers on all simulation nodes in one pass over the nodes and their faces
+   */
+  static std::list<boost::shared_ptr<CarRelayTracer> >
+  Install (boost::shared_ptr<Sinks> sinks);
 
   /**
    * @brief Trace constructor that attaches to the node using node pointer
-   * @param os    reference to the output stream
+   * @param sinks destinations of the events
    * @param node  pointer to the node
    */
-  CarRelayTracer (boost::shared_ptr<std::ostream> os, Ptr<Node> node);
+  CarRelayTracer (boost::shared_ptr<Sinks> sinks, Ptr<Node> node);
 
+  /**
+   * @brief Connect trace sources of the node that are needed by the sinks (each source only once)
+   */
   void
-  ConnectDistance ();
+  Connect ();
 
-  void
-  ConnectJumpDistance ();
+private:
+  static Output
+  OpenOutput (const std::string &file, int types, bool binary);
 
-  void
-  ConnectTx ();
+  /**
+   * @brief Define columns for the event types (Writer is V2vTraceWriter or TextColumns)
+   */
+  template<class Writer>
+  static BinaryColumns
+  CreateColumns (Writer &writer, int types);
 
-  void
-  ConnectInCache ();
+  /**
+   * @brief Write record to the text trace with several event types
+   * @param fields values of the columns the event has, by column index
+   */
+  static void
+  WriteRecord (const Output &output, int event, std::map<uint32_t, std::string> &fields);
 
-private:
   void
   DistanceVsWaiting (double distance, double waiting);
 
   void
-  JumpDistance (Ptr<const Node> node, double jumpDistance);
+  JumpDistance (Ptr<const Node> node, double jumpDistance, Ptr<const Packet> packet);
+
+  /**
+   * @brief Key of the data name, the same in all MPI ranks (interned name ids are assigned per process),
+   *        so propagation fronts of the ranks can be merged (see merge_rank_files in run.py)
+   */
+  static uint32_t
+  GetItemKey (Ptr<const Packet> packet);
+
+  static uint32_t
+  GetItemKey (const Name &name);
 
   void
   Tx (Ptr<Node> node, Ptr<const Packet>, const Vector &pos);
 
   void InCache (Ptr<const ndn::cs::Entry> entry);
 
+  void
+  WritePosition (const Output &output, int event, const Vector &pos);
+
 private:
   std::string m_node;
   Ptr<Node> m_nodePtr;
 
-  boost::shared_ptr<std::ostream> m_os;
+  boost::shared_ptr<Sinks> m_sinks;
 };
 
 } // namespace ndn
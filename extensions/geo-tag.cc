@@ -20,9 +20,40 @@
 
 #include "geo-tag.h"
 
+#include "ns3/packet.h"
+#include "ns3/packet-tag-list.h"
+
+#include <boost/static_assert.hpp>
+#include <cmath>
+#include <cstring>
+
 namespace ns3
 {
 
+// Packet tags are stored in fixed-size slots of PacketTagList (20 bytes in
+// ns-3-dev-ndnSIM, ndnSIM-0.4.3).  Larger tags overflow the slot in optimized builds
+#ifdef PACKET_TAG_MAX_SIZE
+static const uint32_t GEO_TAG_MAX_SIZE = PACKET_TAG_MAX_SIZE;
+#else
+static const uint32_t GEO_TAG_MAX_SIZE = 20;
+#endif
+
+static const uint32_t GEO_TAG_SIZE = 2 * sizeof (double);
+// heading is quantized to 16-bit angle
+static const uint32_t GEO_SRC_TAG_SIZE = GEO_TAG_SIZE + sizeof (uint16_t);
+// radius is stored as float
+static const uint32_t GEO_SCOPE_TAG_SIZE = GEO_TAG_SIZE + sizeof (uint32_t);
+
+BOOST_STATIC_ASSERT (GEO_TAG_SIZE <= GEO_TAG_MAX_SIZE);
+BOOST_STATIC_ASSERT (GEO_SRC_TAG_SIZE <= GEO_TAG_MAX_SIZE);
+BOOST_STATIC_ASSERT (GEO_SCOPE_TAG_SIZE <= GEO_TAG_MAX_SIZE);
+BOOST_STATIC_ASSERT (sizeof (float) == sizeof (uint32_t));
+
+// value of the quantized heading when heading is not set
+static const uint16_t NO_HEADING = 0xFFFF;
+// number of quantization steps of the heading angle (NO_HEADING is reserved)
+static const double HEADING_STEPS = 0xFFFF;
+
 TypeId
 GeoTag::GetTypeId ()
 {
@@ -46,6 +77,17 @@ GeoSrcTag::GetTypeId ()
 {
   static TypeId tid = TypeId ("ns3::GeoSrcTag")
     .SetParent<GeoTag> ()
+    .AddConstructor<GeoSrcTag> () // needed to transfer the tag between MPI ranks
+  ;
+  return tid;
+}
+
+TypeId
+GeoScopeTag::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::GeoScopeTag")
+    .SetParent<GeoTag> ()
+    .AddConstructor<GeoScopeTag> () // needed to transfer the tag between MPI ranks
   ;
   return tid;
 }
@@ -69,7 +111,7 @@ GeoTag::GetPosition () const
 uint32_t
 GeoTag::GetSerializedSize() const
 {
-  return 2 * sizeof (double);
+  return GEO_TAG_SIZE;
 }
 
 void
@@ -94,5 +136,173 @@ GeoTag::Print(std::ostream &os) const
   os << m_position;
 }
 
+GeoSrcTag::GeoSrcTag ()
+{
+}
+
+void
+GeoSrcTag::SetHeading (const Vector &heading)
+{
+  double length = std::sqrt (heading.x * heading.x + heading.y * heading.y);
+  if (length > 0)
+    {
+      m_heading = Vector (heading.x / length, heading.y / length, 0);
+    }
+  else
+    {
+      m_heading = Vector ();
+    }
+}
+
+const Vector &
+GeoSrcTag::GetHeading () const
+{
+  return m_heading;
+}
+
+bool
+GeoSrcTag::HasHeading () const
+{
+  return m_heading.x != 0 || m_heading.y != 0;
+}
+
+double
+GeoSrcTag::GetProgress (const Vector &from, const Vector &to) const
+{
+  if (!HasHeading ())
+    return CalculateDistance (from, to);
+
+  return (to.x - from.x) * m_heading.x + (to.y - from.y) * m_heading.y;
+}
+
+uint32_t
+GeoSrcTag::GetSerializedSize() const
+{
+  return GEO_SRC_TAG_SIZE;
+}
+
+void
+GeoSrcTag::Serialize(TagBuffer i) const
+{
+  i.WriteDouble (GetPosition ().x);
+  i.WriteDouble (GetPosition ().y);
+
+  if (!HasHeading ())
+    {
+      i.WriteU16 (NO_HEADING);
+      return;
+    }
+
+  double angle = std::atan2 (m_heading.y, m_heading.x);
+  if (angle < 0)
+    angle += 2 * M_PI;
+
+  uint32_t step = static_cast<uint32_t> (angle / (2 * M_PI) * HEADING_STEPS + 0.5);
+  i.WriteU16 (static_cast<uint16_t> (step % NO_HEADING));
+}
+
+void
+GeoSrcTag::Deserialize(ns3::TagBuffer i)
+{
+  Vector position;
+  position.x = i.ReadDouble ();
+  position.y = i.ReadDouble ();
+  SetPosition (position);
+
+  uint16_t step = i.ReadU16 ();
+  if (step == NO_HEADING)
+    {
+      m_heading = Vector ();
+      return;
+    }
+
+  double angle = step * 2 * M_PI / HEADING_STEPS;
+  SetHeading (Vector (std::cos (angle), std::sin (angle), 0));
+}
+
+void
+GeoSrcTag::Print(std::ostream &os) const
+{
+  GeoTag::Print (os);
+  if (HasHeading ())
+    os << " heading=" << m_heading;
+}
+
+GeoScopeTag::GeoScopeTag ()
+  : m_radius (0)
+{
+}
+
+void
+GeoScopeTag::SetRadius (double radius)
+{
+  m_radius = radius;
+}
+
+double
+GeoScopeTag::GetRadius () const
+{
+  return m_radius;
+}
+
+bool
+GeoScopeTag::IsInside (const Vector &position) const
+{
+  // scope is two-dimensional, as the serialized position
+  double dx = position.x - GetPosition ().x;
+  double dy = position.y - GetPosition ().y;
+  return dx * dx + dy * dy <= m_radius * m_radius;
+}
+
+bool
+GeoScopeTag::IsInScope (Ptr<const Packet> packet, const Vector &position)
+{
+  GeoScopeTag tag;
+  if (!packet->PeekPacketTag (tag))
+    return true;
+
+  return tag.IsInside (position);
+}
+
+uint32_t
+GeoScopeTag::GetSerializedSize() const
+{
+  return GEO_SCOPE_TAG_SIZE;
+}
+
+void
+GeoScopeTag::Serialize(TagBuffer i) const
+{
+  // TagBuffer is passed by value, so the base class cannot write the position for us
+  i.WriteDouble (GetPosition ().x);
+  i.WriteDouble (GetPosition ().y);
+
+  // TagBuffer has no float accessors
+  float radius = static_cast<float> (m_radius);
+  uint32_t bits;
+  std::memcpy (&bits, &radius, sizeof (bits));
+  i.WriteU32 (bits);
+}
+
+void
+GeoScopeTag::Deserialize(ns3::TagBuffer i)
+{
+  Vector position;
+  position.x = i.ReadDouble ();
+  position.y = i.ReadDouble ();
+  SetPosition (position);
+
+  uint32_t bits = i.ReadU32 ();
+  float radius;
+  std::memcpy (&radius, &bits, sizeof (radius));
+  m_radius = radius;
+}
+
+void
+GeoScopeTag::Print(std::ostream &os) const
+{
+  GeoTag::Print (os);
+  os << " r=" << m_radius;
+}
 
 } // namespace ns3
@@ -24,10 +24,13 @@
 
 #include "ns3/tag.h"
 #include "ns3/vector.h"
+#include "ns3/ptr.h"
 
 namespace ns3
 {
 
+class Packet;
+
 /**
  * \ingroup Ndn
  * \brief Tag store geo position
@@ -92,6 +95,9 @@ public:
 /**
  * \ingroup Ndn
  * @brief Tag to mark originator
+ *
+ * Originator can also specify the intended propagation heading of the packet.  Nodes
+ * that are not farther along the heading than the previous hop do not push the packet
  */
 class GeoSrcTag : public GeoTag
 {
@@ -104,6 +110,112 @@ public:
   {
     return GeoSrcTag::GetTypeId ();
   }
+
+  GeoSrcTag ();
+
+  /**
+   * \brief Set intended propagation heading (zero vector means that packet propagates in all directions)
+   *
+   * Heading is normalized, only x and y components are used.  To fit the tag into the
+   * packet tag slot, heading is carried as 16-bit angle (precision is about 0.0001 rad)
+   */
+  void
+  SetHeading (const Vector &heading);
+
+  /**
+   * \brief Get unit vector of the propagation heading (zero vector if heading is not set)
+   */
+  const Vector &
+  GetHeading () const;
+
+  bool
+  HasHeading () const;
+
+  /**
+   * \brief Get progress along the heading made by the hop from \p from to \p to
+   *
+   * If heading is not set, returns Euclidean distance between the positions
+   */
+  double
+  GetProgress (const Vector &from, const Vector &to) const;
+
+  // from Tag
+  virtual uint32_t
+  GetSerializedSize() const;
+
+  virtual void
+  Serialize(TagBuffer i) const;
+
+  virtual void
+  Deserialize(TagBuffer i);
+
+  virtual void
+  Print(std::ostream&) const;
+
+private:
+  Vector m_heading;
+};
+
+/**
+ * \ingroup Ndn
+ * @brief Tag to limit dissemination of the packet to a geographic region
+ *
+ * Region is a circle with the center at the tag position.  Nodes outside the region
+ * still receive and cache the packet, but do not forward or push it any further.
+ * Packets without the tag are not limited.
+ */
+class GeoScopeTag : public GeoTag
+{
+public:
+  static TypeId
+  GetTypeId ();
+
+  virtual
+  TypeId GetInstanceTypeId () const
+  {
+    return GeoScopeTag::GetTypeId ();
+  }
+
+  GeoScopeTag ();
+
+  /**
+   * \brief Set radius of the region around the tag position
+   *
+   * Radius is carried with float precision to fit the tag into the packet tag slot
+   */
+  void
+  SetRadius (double radius);
+
+  double
+  GetRadius () const;
+
+  /**
+   * \brief Check if \p position is inside the region
+   */
+  bool
+  IsInside (const Vector &position) const;
+
+  /**
+   * \brief Check if node at \p position may forward \p packet (i.e., packet is not scoped or position is inside its scope)
+   */
+  static bool
+  IsInScope (Ptr<const Packet> packet, const Vector &position);
+
+  // from Tag
+  virtual uint32_t
+  GetSerializedSize() const;
+
+  virtual void
+  Serialize(TagBuffer i) const;
+
+  virtual void
+  Deserialize(TagBuffer i);
+
+  virtual void
+  Print(std::ostream&) const;
+
+private:
+  double m_radius;
 };
 
 } // namespace ns3
@@ -20,6 +20,7 @@
 
 #include "ndn-fw-v2v.h"
 #include "ndn-v2v-net-device-face.h"
+#include "v2v-packet-info-tag.h"
 #include "geo-tag.h"
 
 #include <ns3/ndnSIM/utils/ndn-fw-hop-count-tag.h>
@@ -36,9 +37,13 @@
 #include <ns3/ndn-content-store.h>
 #include <ns3/ndn-app-face.h>
 #include <ns3/mobility-model.h>
+#include <ns3/double.h>
+#include <ns3/uinteger.h>
 
 #include <boost/foreach.hpp>
 
+#include <algorithm>
+
 NS_LOG_COMPONENT_DEFINE ("ndn.fw.V2v");
 
 namespace ns3 {
@@ -55,11 +60,37 @@ V2v::GetTypeId (void)
     .SetGroupName ("Ndn")
     .AddConstructor<V2v> ()
 
+    .AddAttribute ("ScopeRadius", "Radius of the geographic scope around the originator, attached to locally "
+                   "originated Interests and Data that do not have the scope yet (zero means no scope). "
+                   "Nodes outside the scope do not forward or push the packet",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&V2v::m_scopeRadius),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("PropagationHeading", "Intended propagation heading of locally originated Data (zero vector means all directions). "
+                   "Nodes that are not farther along the heading than the previous hop do not push the Data",
+                   VectorValue (Vector (0, 0, 0)),
+                   MakeVectorAccessor (&V2v::m_propagationHeading),
+                   MakeVectorChecker ())
+
+    .AddAttribute ("DuplicateFilterLifetime", "How long name and nonce of the received Interest are remembered to drop its duplicates "
+                   "before PIT processing (zero disables the filter and leaves duplicate detection to PIT)",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&V2v::SetDuplicateFilterLifetime, &V2v::GetDuplicateFilterLifetime),
+                   MakeTimeChecker ())
+    .AddAttribute ("DuplicateFilterSize", "Size of one generation of the duplicate filter, in bits",
+                   UintegerValue (16384),
+                   MakeUintegerAccessor (&V2v::SetDuplicateFilterSize, &V2v::GetDuplicateFilterSize),
+                   MakeUintegerChecker<uint32_t> (64))
+    .AddAttribute ("DuplicateFilterHashes", "Number of hash functions of the duplicate filter",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&V2v::SetDuplicateFilterHashes, &V2v::GetDuplicateFilterHashes),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
   return tid;
 }
 
 V2v::V2v()
+  : m_scopeRadius (0.0)
 {
 }
 
@@ -67,6 +98,38 @@ V2v::~V2v ()
 {
 }
 
+void
+V2v::DoDispose ()
+{
+  m_v2vFaces.clear ();
+
+  ForwardingStrategy::DoDispose ();
+}
+
+void
+V2v::AddFace (Ptr<Face> face)
+{
+  ForwardingStrategy::AddFace (face);
+
+  Ptr<V2vNetDeviceFace> v2vFace = DynamicCast<V2vNetDeviceFace> (face);
+  if (v2vFace != 0)
+    {
+      m_v2vFaces.push_back (v2vFace);
+    }
+}
+
+void
+V2v::RemoveFace (Ptr<Face> face)
+{
+  std::vector< Ptr<V2vNetDeviceFace> >::iterator v2vFace = std::find (m_v2vFaces.begin (), m_v2vFaces.end (), face);
+  if (v2vFace != m_v2vFaces.end ())
+    {
+      m_v2vFaces.erase (v2vFace);
+    }
+
+  ForwardingStrategy::RemoveFace (face);
+}
+
 void
 V2v::OnInterest (Ptr<Face> face,
                  Ptr<const InterestHeader> header,
@@ -82,6 +145,21 @@ V2v::OnInterest (Ptr<Face> face,
           GeoSrcTag tag;
           tag.SetPosition (position);
           origPacket->AddPacketTag (tag);
+          AddScope (origPacket, position);
+        }
+    }
+
+  // header is already parsed, cache the result for faces and tracers
+  V2vPacketInfoTag::Attach (origPacket, HeaderHelper::INTEREST_NDNSIM, header->GetName ());
+
+  if (m_duplicateFilter.IsEnabled ())
+    {
+      uint64_t key = (static_cast<uint64_t> (V2vPacketInfoTag::Get (origPacket).GetNameId ()) << 32) | header->GetNonce ();
+      if (m_duplicateFilter.TestAndInsert (key))
+        {
+          NS_LOG_DEBUG ("Duplicate Interest " << header->GetName () << " (nonce " << header->GetNonce () << "), dropping");
+          m_dropInterests (header, face);
+          return;
         }
     }
 
@@ -103,11 +181,16 @@ V2v::OnData (Ptr<Face> face,
           position = model->GetPosition ();
           GeoSrcTag tag;
           tag.SetPosition (position);
+          tag.SetHeading (m_propagationHeading);
           origPacket->AddPacketTag (tag);
           // payload->AddPacketTag (tag);
+          AddScope (origPacket, position);
         }
     }
 
+  // header is already parsed, cache the result for faces and tracers
+  V2vPacketInfoTag::Attach (origPacket, HeaderHelper::CONTENT_OBJECT_NDNSIM, header->GetName ());
+
   ForwardingStrategy::OnData (face, header, payload, origPacket);
 }
 
@@ -120,6 +203,12 @@ V2v::DoPropagateInterest (Ptr<Face> inFace,
 {
   NS_LOG_FUNCTION (this);
 
+  if (!IsInScope (origPacket))
+    {
+      NS_LOG_DEBUG ("Node is outside of the Interest scope, don't propagate it");
+      return false;
+    }
+
   int propagatedCount = 0;
 
   BOOST_FOREACH (const fib::FaceMetric &metricFace, pitEntry->GetFibEntry ()->m_faces.get<fib::i_metric> ())
@@ -154,15 +243,7 @@ V2v::DidReceiveSolicitedData (Ptr<Face> inFace,
   if (didCreateCacheEntry)
     {
       // initiate low priority "pushing" only for "new data packets"
-
-      Ptr<L3Protocol> l3 = this->GetObject<L3Protocol> ();
-      NS_ASSERT (l3 != 0);
-
-      // Push interest using low-priority send method
-      for (uint32_t faceId = 0; faceId < l3->GetNFaces (); faceId++)
-        {
-          TrySendLowPriority (l3->GetFace (faceId), origPacket);
-        }
+      PushLowPriority (origPacket);
     }
 }
 
@@ -178,15 +259,7 @@ V2v::DidReceiveUnsolicitedData (Ptr<Face> inFace,
   if (didCreateCacheEntry)
     {
       // initiate low priority "pushing" only for "new data packets"
-
-      Ptr<L3Protocol> l3 = this->GetObject<L3Protocol> ();
-      NS_ASSERT (l3 != 0);
-
-      // Push interest using low-priority send method
-      for (uint32_t faceId = 0; faceId < l3->GetNFaces (); faceId++)
-        {
-          TrySendLowPriority (l3->GetFace (faceId), origPacket);
-        }
+      PushLowPriority (origPacket);
     }
 }
 
@@ -198,26 +271,92 @@ V2v::DidExhaustForwardingOptions (Ptr<Face> inFace,
 {
   ForwardingStrategy::DidExhaustForwardingOptions (inFace, header, origPacket, pitEntry);
 
-  // Try to push new packet further with lowest priority possible on all L3 faces
-  BOOST_FOREACH (const fib::FaceMetric &face, pitEntry->GetFibEntry ()->m_faces)
+  if (!IsInScope (origPacket))
+    return;
+
+  // Try to push new packet further with lowest priority possible on all V2V faces of the FIB entry
+  const fib::FaceMetricContainer::type &faces = pitEntry->GetFibEntry ()->m_faces;
+  for (std::vector< Ptr<V2vNetDeviceFace> >::const_iterator face = m_v2vFaces.begin (); face != m_v2vFaces.end (); face++)
     {
-      //TrySendLowPriority (face.m_face, origPacket);
-      TrySendLowPriority (face.GetFace (), origPacket);
+      if (faces.get<fib::i_face> ().find (Ptr<Face> (*face)) == faces.get<fib::i_face> ().end ())
+        continue;
+
+      (*face)->SendLowPriority (origPacket); // packet is not modified by the face, no need to copy
     }
 }
 
 void
-V2v::TrySendLowPriority (Ptr<Face> face, Ptr<const Packet> packet)
+V2v::PushLowPriority (Ptr<const Packet> packet)
 {
-  NS_LOG_FUNCTION (boost::cref (*face));
+  if (!IsInScope (packet))
+    {
+      NS_LOG_DEBUG ("Node is outside of the Data scope, don't push it");
+      return;
+    }
 
-  Ptr<V2vNetDeviceFace> v2vFace = DynamicCast<V2vNetDeviceFace> (face);
-  if (v2vFace)
+  for (std::vector< Ptr<V2vNetDeviceFace> >::const_iterator face = m_v2vFaces.begin (); face != m_v2vFaces.end (); face++)
     {
-      v2vFace->SendLowPriority (packet->Copy ());
+      (*face)->SendLowPriority (packet); // packet is not modified by the face, no need to copy
     }
 }
 
+void
+V2v::AddScope (Ptr<const Packet> packet, const Vector &position)
+{
+  GeoScopeTag tag;
+  if (m_scopeRadius <= 0 || packet->PeekPacketTag (tag))
+    return; // scope is disabled or set by the application
+
+  tag.SetPosition (position);
+  tag.SetRadius (m_scopeRadius);
+  packet->AddPacketTag (tag);
+}
+
+void
+V2v::SetDuplicateFilterLifetime (const Time &lifetime)
+{
+  m_duplicateFilter.SetLifetime (lifetime);
+}
+
+Time
+V2v::GetDuplicateFilterLifetime () const
+{
+  return m_duplicateFilter.GetLifetime ();
+}
+
+void
+V2v::SetDuplicateFilterSize (uint32_t bits)
+{
+  m_duplicateFilter.SetSize (bits);
+}
+
+uint32_t
+V2v::GetDuplicateFilterSize () const
+{
+  return m_duplicateFilter.GetSize ();
+}
+
+void
+V2v::SetDuplicateFilterHashes (uint32_t hashes)
+{
+  m_duplicateFilter.SetHashCount (hashes);
+}
+
+uint32_t
+V2v::GetDuplicateFilterHashes () const
+{
+  return m_duplicateFilter.GetHashCount ();
+}
+
+bool
+V2v::IsInScope (Ptr<const Packet> packet) const
+{
+  Ptr<MobilityModel> model = GetObject<MobilityModel> ();
+  if (model == 0)
+    return true;
+
+  return GeoScopeTag::IsInScope (packet, model->GetPosition ());
+}
 
 } // namespace fw
 } // namespace ndn
@@ -22,9 +22,17 @@
 #define NDN_FW_V2V_H
 
 #include "ns3/ndn-forwarding-strategy.h"
+#include "ns3/vector.h"
+
+#include "v2v-duplicate-filter.h"
+
+#include <vector>
 
 namespace ns3 {
 namespace ndn {
+
+class V2vNetDeviceFace;
+
 namespace fw {
 
 /**
@@ -54,6 +62,12 @@ public:
           Ptr<Packet> payload,
           Ptr<const Packet> origPacket);
 
+  virtual void
+  AddFace (Ptr<Face> face);
+
+  virtual void
+  RemoveFace (Ptr<Face> face);
+
 protected:
   // from ForwardingStrategy
   virtual bool
@@ -82,9 +96,56 @@ protected:
                              Ptr<const Packet> payload,
                              Ptr<const Packet> origPacket,
                              bool didCreateCacheEntry);
+  virtual void
+  DoDispose ();
+
 private:
+  /**
+   * \brief Schedule low-priority transmission of the packet on all V2V faces
+   */
+  void
+  PushLowPriority (Ptr<const Packet> packet);
+
+  /**
+   * \brief Attach GeoScopeTag centered at \p position to the locally originated packet (if ScopeRadius is set)
+   */
   void
-  TrySendLowPriority (Ptr<Face> face, Ptr<const Packet> packet);
+  AddScope (Ptr<const Packet> packet, const Vector &position);
+
+  /**
+   * \brief Check if the node is allowed to forward or push the packet (see GeoScopeTag)
+   */
+  bool
+  IsInScope (Ptr<const Packet> packet) const;
+
+  void
+  SetDuplicateFilterLifetime (const Time &lifetime);
+
+  Time
+  GetDuplicateFilterLifetime () const;
+
+  void
+  SetDuplicateFilterSize (uint32_t bits);
+
+  uint32_t
+  GetDuplicateFilterSize () const;
+
+  void
+  SetDuplicateFilterHashes (uint32_t hashes);
+
+  uint32_t
+  GetDuplicateFilterHashes () const;
+
+private:
+  // V2V faces of the node, maintained on face addition and removal, so push does not need to
+  // check type of every face for every new data packet
+  std::vector< Ptr<V2vNetDeviceFace> > m_v2vFaces;
+
+  double m_scopeRadius;
+  Vector m_propagationHeading;
+
+  // Recently seen Interests (name and nonce), so duplicates are dropped without relying on long-living PIT entries
+  V2vDuplicateFilter m_duplicateFilter;
 };
 
 } // namespace fw
@@ -20,6 +20,10 @@
  */
 
 #include "ndn-v2v-net-device-face.h"
+#include "v2v-packet-info-tag.h"
+#include "v2v-aggregate-header.h"
+#include "v2v-delay-policy.h"
+#include "v2v-suppression-policy.h"
 #include "geo-tag.h"
 
 #include "ns3/ndn-l3-protocol.h"
@@ -34,8 +38,13 @@
 #include "ns3/pointer.h"
 #include "ns3/uinteger.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/object-factory.h"
 #include "ns3/ndn-name-components.h"
 
+#include <limits>
+
 NS_LOG_COMPONENT_DEFINE ("ndn.V2vNetDeviceFace");
 
 namespace ns3 {
@@ -43,6 +52,8 @@ namespace ndn {
 
 NS_OBJECT_ENSURE_REGISTERED (V2vNetDeviceFace);
 
+const uint16_t V2vNetDeviceFace::AGGREGATE_FRAME_TYPE = 0x7778;
+
 TypeId
 V2vNetDeviceFace::GetTypeId ()
 {
@@ -64,6 +75,17 @@ V2vNetDeviceFace::GetTypeId ()
                    MakeDoubleAccessor (&V2vNetDeviceFace::m_maxDistance),
                    MakeDoubleChecker<double> ())
 
+    .AddAttribute ("DelayPolicy", "TypeId of the policy that defines waiting time of low-priority packets "
+                   "(ns3::ndn::V2vLinearDelayPolicy, ns3::ndn::V2vExponentialDelayPolicy, ns3::ndn::V2vSlottedDelayPolicy)",
+                   StringValue ("ns3::ndn::V2vLinearDelayPolicy"),
+                   MakeStringAccessor (&V2vNetDeviceFace::SetDelayPolicy, &V2vNetDeviceFace::GetDelayPolicy),
+                   MakeStringChecker ())
+    .AddAttribute ("SuppressionPolicy", "TypeId of the policy that decides whether queued transmission is cancelled when the same name is overheard "
+                   "(ns3::ndn::V2vDistanceSuppressionPolicy, ns3::ndn::V2vCounterSuppressionPolicy, ns3::ndn::V2vCoverageSuppressionPolicy)",
+                   StringValue ("ns3::ndn::V2vDistanceSuppressionPolicy"),
+                   MakeStringAccessor (&V2vNetDeviceFace::SetSuppressionPolicy, &V2vNetDeviceFace::GetSuppressionPolicy),
+                   MakeStringChecker ())
+
     .AddAttribute ("MaxDelayRetransmission", "Maximum delay between successive retransmissions of low-priority pushed packets",
                    TimeValue (Seconds (0.050)),
                    MakeTimeAccessor (&V2vNetDeviceFace::m_maxWaitRetransmission),
@@ -73,6 +95,29 @@ V2vNetDeviceFace::GetTypeId ()
                    MakeUintegerAccessor (&V2vNetDeviceFace::m_maxRetxAttempts),
                    MakeUintegerChecker<uint32_t> ())
 
+    .AddAttribute ("Aggregation", "Pack several queued packets into one link-layer frame (only packets that have already waited their gap are packed behind the front one; the frame is unpacked by the receiving face)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&V2vNetDeviceFace::m_aggregation),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxAggregateSize", "Maximum size of the aggregated frame payload (should not exceed fragmentation threshold of the MAC)",
+                   UintegerValue (2200),
+                   MakeUintegerAccessor (&V2vNetDeviceFace::m_maxAggregateSize),
+                   MakeUintegerChecker<uint32_t> ())
+
+    .AddAttribute ("AdaptiveDelays", "Adapt jitter window and gradient normalization distance to the density of "
+                   "the overheard neighbors (MaxDelay and MaxDistance are then used only as upper bound and fallback)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&V2vNetDeviceFace::m_adaptiveDelays),
+                   MakeBooleanChecker ())
+    .AddAttribute ("JitterSlot", "Per-neighbor increment of the jitter window in the adaptive mode",
+                   TimeValue (MicroSeconds (100)),
+                   MakeTimeAccessor (&V2vNetDeviceFace::m_jitterSlot),
+                   MakeTimeChecker ())
+    .AddAttribute ("NeighborTimeout", "Time after which a silent neighbor is removed from the neighbor table",
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&V2vNetDeviceFace::SetNeighborTimeout, &V2vNetDeviceFace::GetNeighborTimeout),
+                   MakeTimeChecker ())
+
     .AddTraceSource ("WaitingTimeVsDistanceDataTrace", "On every low-priority packet trace the waiting gap and distance",
                      MakeTraceSourceAccessor (&V2vNetDeviceFace::m_waitingTimeVsDistanceDataTrace))
     .AddTraceSource ("WaitingTimeVsDistanceInterestTrace", "On every low-priority packet trace the waiting gap and distance",
@@ -88,10 +133,14 @@ V2vNetDeviceFace::GetTypeId ()
     .AddTraceSource ("TxInterest", "Fired every time packet is send out of face",
                      MakeTraceSourceAccessor (&V2vNetDeviceFace::m_txInterest))
 
-    .AddTraceSource ("CancelingData", "Fired every time transmission is cancelled",
+    .AddTraceSource ("CancelingData", "Fired every time queued transmission (of Data or Interest) is cancelled (suppressed) by the SuppressionPolicy",
                      MakeTraceSourceAccessor (&V2vNetDeviceFace::m_cancellingData))
-    .AddTraceSource ("CancelingInterest", "Fired every time transmission is cancelled",
+    .AddTraceSource ("CancelingInterest", "Not fired, cancellations of Interests are reported through CancelingData",
                      MakeTraceSourceAccessor (&V2vNetDeviceFace::m_cancellingInterest))
+
+    .AddTraceSource ("Drop", "Fired every time packet is not admitted to the queue: the queue is full, the node is outside of "
+                     "the packet's geographic scope, or the node is behind the previous hop along the propagation heading",
+                     MakeTraceSourceAccessor (&V2vNetDeviceFace::m_drop))
     ;
   return tid;
 }
@@ -103,6 +152,7 @@ V2vNetDeviceFace::GetTypeId ()
 V2vNetDeviceFace::V2vNetDeviceFace (Ptr<Node> node, const Ptr<NetDevice> &netDevice)
   : NetDeviceFace (node, netDevice)
   , m_maxPacketsInQueue (100)
+  , m_retxPending (false)
 {
   NS_LOG_FUNCTION (this << node << netDevice);
 
@@ -175,46 +225,119 @@ V2vNetDeviceFace::GetMaxDelayLowPriority () const
   return m_maxWaitLowPriority;
 }
 
+const V2vFaceStats &
+V2vNetDeviceFace::GetStats () const
+{
+  return m_stats;
+}
 
-V2vNetDeviceFace::Item::Item (const Time &gap, const Ptr<Packet> &packet)
-  : m_gap (gap), m_packet (packet), m_retxCount (0)
+void
+V2vNetDeviceFace::SetDelayPolicy (const std::string &typeId)
 {
-  // NS_LOG_FUNCTION (this << _gap << _packet);
+  ObjectFactory factory;
+  factory.SetTypeId (typeId);
 
-  m_name = HeaderHelper::GetName (packet); // not efficient (extra deserialization), but it is the only way for now
-  NS_ASSERT (m_name != 0);
+  m_delayPolicy = factory.Create<V2vDelayPolicy> ();
+  NS_ASSERT_MSG (m_delayPolicy != 0, typeId << " is not a V2vDelayPolicy");
+}
 
-  HeaderHelper::Type guessedType = HeaderHelper::GetNdnHeaderType (packet);
-  if (guessedType == HeaderHelper::INTEREST_CCNB ||
-      guessedType == HeaderHelper::INTEREST_NDNSIM)
-    {
-      m_type = HeaderHelper::INTEREST_NDNSIM;
-      NS_LOG_DEBUG ("Schedule low-priority Interest");
-    }
-  else if (guessedType == HeaderHelper::CONTENT_OBJECT_CCNB ||
-           guessedType == HeaderHelper::CONTENT_OBJECT_NDNSIM)
-    {
-      m_type = HeaderHelper::CONTENT_OBJECT_NDNSIM;
-      NS_LOG_DEBUG ("Schedule low-priority ContentObject");
-    }
-  else
-    {
-      NS_FATAL_ERROR ("Unknown NDN header type");
-    }
+std::string
+V2vNetDeviceFace::GetDelayPolicy () const
+{
+  if (m_delayPolicy == 0)
+    return "";
+
+  return m_delayPolicy->GetInstanceTypeId ().GetName ();
+}
+
+void
+V2vNetDeviceFace::SetSuppressionPolicy (const std::string &typeId)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (typeId);
+
+  m_suppressionPolicy = factory.Create<V2vSuppressionPolicy> ();
+  NS_ASSERT_MSG (m_suppressionPolicy != 0, typeId << " is not a V2vSuppressionPolicy");
 }
 
-V2vNetDeviceFace::Item::Item (const Item &item)
-  : m_gap (item.m_gap), m_packet (item.m_packet), m_type (item.m_type), m_name (item.m_name), m_retxCount (item.m_retxCount)
+std::string
+V2vNetDeviceFace::GetSuppressionPolicy () const
 {
+  if (m_suppressionPolicy == 0)
+    return "";
+
+  return m_suppressionPolicy->GetInstanceTypeId ().GetName ();
+}
+
+void
+V2vNetDeviceFace::SetNeighborTimeout (const Time &value)
+{
+  m_neighbors.SetTimeout (value);
+}
+
+Time
+V2vNetDeviceFace::GetNeighborTimeout () const
+{
+  return m_neighbors.GetTimeout ();
+}
+
+Time
+V2vNetDeviceFace::GetJitterWindow ()
+{
+  if (!m_adaptiveDelays)
+    return m_maxWaitPeriod;
+
+  Ptr<MobilityModel> mobility = m_node->GetObject<MobilityModel> ();
+  if (mobility == 0)
+    return m_maxWaitPeriod;
+
+  // one contention slot per potential forwarder, bounded by MaxDelay
+  uint32_t neighbors = m_neighbors.GetNeighborCount (mobility->GetPosition ());
+  Time window = Seconds (m_jitterSlot.ToDouble (Time::S) * std::max<uint32_t> (neighbors, 1));
+  return std::min (window, m_maxWaitPeriod);
+}
+
+double
+V2vNetDeviceFace::GetNormalizationDistance ()
+{
+  if (!m_adaptiveDelays)
+    return m_maxDistance;
+
+  Ptr<MobilityModel> mobility = m_node->GetObject<MobilityModel> ();
+  if (mobility == 0)
+    return m_maxDistance;
+
+  // farthest neighbor heard is the best estimate of the effective transmission range
+  double distance = m_neighbors.GetMaxDistance (mobility->GetPosition ());
+  if (distance <= 0)
+    return m_maxDistance;
+
+  return distance;
+}
+
+
+V2vNetDeviceFace::Item::Item ()
+  : m_nameId (0), m_type (HeaderHelper::CONTENT_OBJECT_NDNSIM), m_retxCount (0), m_overheard (0)
+  , m_prevSameName (ItemQueue::npos), m_nextSameName (ItemQueue::npos)
+{
+}
+
+V2vNetDeviceFace::Item::Item (const Time &gap, const Ptr<const Packet> &packet)
+  : m_gap (gap), m_packet (packet), m_retxCount (0), m_overheard (0)
+  , m_prevSameName (ItemQueue::npos), m_nextSameName (ItemQueue::npos)
+{
+  // NS_LOG_FUNCTION (this << _gap << _packet);
+
+  V2vPacketInfoTag info = V2vPacketInfoTag::Get (packet); // NDN header is parsed only if packet is not yet tagged
+  m_type = info.GetType ();
+  m_nameId = info.GetNameId ();
 }
 
 V2vNetDeviceFace::Item &
 V2vNetDeviceFace::Item::operator ++ ()
 {
-  // remote GeoTag when packet is scheduled for retransmission
-  GeoTransmissionTag tag;
-  m_packet->RemovePacketTag (tag);
-
+  // Stored packet is shared and never modified. GeoTransmissionTag of the previous hop
+  // is replaced on the transmitted copy (see TagAndNetDeviceSendImpl)
   m_retxCount ++;
   return *this;
 }
@@ -226,13 +349,107 @@ V2vNetDeviceFace::Item::Gap (const Time &time)
   return *this;
 }
 
+V2vNetDeviceFace::ItemQueue &
+V2vNetDeviceFace::GetQueue (QueueType type)
+{
+  switch (type)
+    {
+    case PRIMARY_QUEUE:
+      return m_queue;
+    case LOW_PRIORITY_QUEUE:
+      return m_lowPriorityQueue;
+    case RETX_QUEUE:
+      return m_retxQueue;
+    default:
+      NS_FATAL_ERROR ("Unknown queue type");
+      return m_queue;
+    }
+}
+
+V2vNetDeviceFace::IndexEntry::IndexEntry ()
+{
+  for (uint32_t i = 0; i < QUEUE_TYPE_COUNT; i++)
+    {
+      m_head[i] = ItemQueue::npos;
+      m_tail[i] = ItemQueue::npos;
+    }
+}
+
+void
+V2vNetDeviceFace::Enqueue (QueueType type, const Item &item)
+{
+  ItemQueue &queue = GetQueue (type);
+  if (queue.capacity () == 0)
+    {
+      // queues are bounded by the MAC queue size, so normally the pool never grows beyond this
+      queue.reserve (m_maxPacketsInQueue);
+    }
+
+  IndexEntry &entry = m_index[item.m_nameId];
+
+  ItemHandle handle = queue.push_back (item);
+  Item &queued = queue[handle];
+  queued.m_enqueued = Simulator::Now ();
+  m_stats.NotifyEnqueued (static_cast<V2vFaceStats::Queue> (type), queue.size ());
+
+  queued.m_prevSameName = entry.m_tail[type];
+  queued.m_nextSameName = ItemQueue::npos;
+  if (entry.m_tail[type] != ItemQueue::npos)
+    queue[entry.m_tail[type]].m_nextSameName = handle;
+  else
+    entry.m_head[type] = handle;
+  entry.m_tail[type] = handle;
+}
+
+void
+V2vNetDeviceFace::Erase (QueueType type, ItemHandle handle)
+{
+  ItemQueue &queue = GetQueue (type);
+  Item &item = queue[handle];
+
+  ItemIndex::iterator found = m_index.find (item.m_nameId);
+  NS_ASSERT (found != m_index.end ());
+  IndexEntry &entry = found->second;
+
+  if (item.m_prevSameName != ItemQueue::npos)
+    queue[item.m_prevSameName].m_nextSameName = item.m_nextSameName;
+  else
+    entry.m_head[type] = item.m_nextSameName;
+
+  if (item.m_nextSameName != ItemQueue::npos)
+    queue[item.m_nextSameName].m_prevSameName = item.m_prevSameName;
+  else
+    entry.m_tail[type] = item.m_prevSameName;
+
+  queue.erase (handle);
+
+  if (entry.m_head[PRIMARY_QUEUE] == ItemQueue::npos &&
+      entry.m_head[LOW_PRIORITY_QUEUE] == ItemQueue::npos &&
+      entry.m_head[RETX_QUEUE] == ItemQueue::npos)
+    {
+      // nothing with the name is waiting anymore (overheard transmitters are not needed either)
+      m_index.erase (found);
+    }
+}
+
+void
+V2vNetDeviceFace::Dequeue (QueueType type)
+{
+  ItemQueue &queue = GetQueue (type);
+  NS_ASSERT (queue.size () > 0);
+
+  Erase (type, queue.begin ());
+}
+
 Time
-V2vNetDeviceFace::GetPriorityQueueGap () const
+V2vNetDeviceFace::GetPriorityQueueGap ()
 {
-  Time gap = Seconds (m_randomPeriod.GetValue ());
-  if (m_totalWaitPeriod < m_maxWaitPeriod)
+  Time maxWaitPeriod = GetJitterWindow ();
+
+  Time gap = Seconds (m_randomPeriod.GetValue (0, maxWaitPeriod.ToDouble (Time::S)));
+  if (m_totalWaitPeriod < maxWaitPeriod)
     {
-      gap = std::min (m_maxWaitPeriod - m_totalWaitPeriod, gap);
+      gap = std::min (maxWaitPeriod - m_totalWaitPeriod, gap);
     }
   else
     gap = Time (0);
@@ -241,15 +458,16 @@ V2vNetDeviceFace::GetPriorityQueueGap () const
 }
 
 void
-V2vNetDeviceFace::SendLowPriority (Ptr<Packet> packet)
+V2vNetDeviceFace::SendLowPriority (Ptr<const Packet> packet)
 {
   NS_LOG_FUNCTION (this << packet);
 
   if (m_queue.size () >= m_maxPacketsInQueue ||
       m_lowPriorityQueue.size () >= m_maxPacketsInQueue)
     {
-      // \todo Maybe add tracing
       NS_LOG_DEBUG ("Too many packets enqueue already. Don't do anything");
+      m_stats.NotifyDropped (V2vFaceStats::DROP_LOW_PRIORITY_FULL);
+      m_drop (m_node, packet);
       return;
     }
 
@@ -263,28 +481,48 @@ V2vNetDeviceFace::SendLowPriority (Ptr<Packet> packet)
       return;
     }
 
-  double distance = m_maxDistance;
-  if (isTag) // if !isTag, it means that packet came from application
+  if (!GeoScopeTag::IsInScope (packet, mobility->GetPosition ()))
     {
-      // NS_LOG_DEBUG ("Tag is OK, distance is " << CalculateDistance (tag->GetPosition (), mobility->GetPosition ()));
-      distance = CalculateDistance (tag.GetPosition (), mobility->GetPosition ());
-      distance = std::min (m_maxDistance, distance);
+      NS_LOG_DEBUG ("Node is outside of the packet scope, don't push it any further");
+      m_stats.NotifyDropped (V2vFaceStats::DROP_OUT_OF_SCOPE);
+      m_drop (m_node, packet);
+      return;
     }
 
+  double maxDistance = GetNormalizationDistance ();
+  double distance = maxDistance;
+  if (isTag) // if !isTag, it means that packet came from application
+    {
+      // In directional mode, gradient is defined by the progress along the propagation heading,
+      // and nodes that are not farther along the heading than the previous hop do not push at all
+      GeoSrcTag srcTag;
+      if (packet->PeekPacketTag (srcTag))
+        {
+          distance = srcTag.GetProgress (tag.GetPosition (), mobility->GetPosition ());
+        }
+      else
+        {
+          distance = CalculateDistance (tag.GetPosition (), mobility->GetPosition ());
+        }
 
-  //////////////////////////////////
-  //////////////////////////////////
+      // NS_LOG_DEBUG ("Tag is OK, distance is " << CalculateDistance (tag->GetPosition (), mobility->GetPosition ()));
+      if (distance <= 0 && srcTag.HasHeading ())
+        {
+          NS_LOG_DEBUG ("Node is behind the previous hop relative to the propagation heading, don't push");
+          m_stats.NotifyDropped (V2vFaceStats::DROP_WRONG_DIRECTION);
+          m_drop (m_node, packet);
+          return;
+        }
+      distance = std::min (maxDistance, distance);
+    }
 
-  // Mean waiting time.  Reversely proportional to the distance from the original transmitter
-  // Closer guys will tend to wait longer than guys far away
-  double meanWaiting = m_maxWaitLowPriority.ToDouble (Time::S) * (m_maxDistance - distance) / m_maxDistance;
 
   //////////////////////////////////
   //////////////////////////////////
 
-  UniformVariable randomLowPriority (meanWaiting, meanWaiting + m_maxWaitPeriod.ToDouble (Time::S));
-
-  double sample = std::abs (randomLowPriority.GetValue ());
+  // Gradient part of the delay (closer guys will tend to wait longer than guys far away)
+  // plus Uniform distribution that is aimed to avoid collisions, as defined by the delay policy
+  double sample = m_delayPolicy->GetDelay (distance, maxDistance, m_maxWaitLowPriority, GetJitterWindow ()).ToDouble (Time::S);
   // NS_LOG_DEBUG ("Sample: " << sample);
 
   Item queueItem (Seconds (sample), packet);
@@ -297,8 +535,7 @@ V2vNetDeviceFace::SendLowPriority (Ptr<Packet> packet)
       m_waitingTimeVsDistanceDataTrace (distance, sample);
     }
 
-  // Actual gap will be defined by Triangular distribution based on Geo metric + Uniform distribution that is aimed to avoid collisions
-  m_lowPriorityQueue.push_back (queueItem);
+  Enqueue (LOW_PRIORITY_QUEUE, queueItem);
 
   if (!m_scheduledSend.IsRunning ())
     m_scheduledSend = Simulator::Schedule (m_lowPriorityQueue.front ().m_gap, &V2vNetDeviceFace::SendFromQueue, this);
@@ -309,9 +546,17 @@ V2vNetDeviceFace::SendImpl (Ptr<Packet> packet)
 {
   NS_LOG_FUNCTION (this << packet);
 
-  HeaderHelper::Type type = HeaderHelper::GetNdnHeaderType (packet);
-  if (type == HeaderHelper::INTEREST_CCNB ||
-      type == HeaderHelper::INTEREST_NDNSIM)
+  Ptr<MobilityModel> mobility = m_node->GetObject<MobilityModel> ();
+  if (mobility != 0 && !GeoScopeTag::IsInScope (packet, mobility->GetPosition ()))
+    {
+      NS_LOG_DEBUG ("Node is outside of the packet scope, don't forward it");
+      m_stats.NotifyDropped (V2vFaceStats::DROP_OUT_OF_SCOPE);
+      m_drop (m_node, packet);
+      return false;
+    }
+
+  V2vPacketInfoTag info = V2vPacketInfoTag::Get (packet);
+  if (info.IsInterest ())
     {
       // send immediately, don't delay
 
@@ -319,18 +564,18 @@ V2vNetDeviceFace::SendImpl (Ptr<Packet> packet)
       return NetDeviceFace::SendImpl (packet);
       //////////////////////////////
     }
-  else if (type == HeaderHelper::CONTENT_OBJECT_CCNB ||
-           type == HeaderHelper::CONTENT_OBJECT_NDNSIM)
+  else
     {
       if (m_queue.size () >= m_maxPacketsInQueue)
         {
-          // \todo Maybe add tracing
           NS_LOG_INFO ("Dropping data packet that exceed queue size");
+          m_stats.NotifyDropped (V2vFaceStats::DROP_PRIMARY_FULL);
+          m_drop (m_node, packet);
           return false;
         }
 
       Time gap = GetPriorityQueueGap ();
-      m_queue.push_back (Item (gap, packet));
+      Enqueue (PRIMARY_QUEUE, Item (gap, packet));
       m_totalWaitPeriod += gap;
 
       if (!m_scheduledSend.IsRunning ())
@@ -338,11 +583,6 @@ V2vNetDeviceFace::SendImpl (Ptr<Packet> packet)
 
       return true;
     }
-  else
-    {
-      NS_FATAL_ERROR ("Unknown or unsupported NDN header type");
-      return false;
-    }
 }
 
 void
@@ -362,7 +602,7 @@ V2vNetDeviceFace::NotifyJumpDistanceInterestTrace (Ptr<const Packet> packet)
 
   double distance = CalculateDistance (tag.GetPosition (), mobility->GetPosition ());
 
-  m_jumpDistanceInterestTrace (m_node, distance);
+  m_jumpDistanceInterestTrace (m_node, distance, packet);
 }
 
 void
@@ -382,7 +622,7 @@ V2vNetDeviceFace::NotifyJumpDistanceDataTrace (Ptr<const Packet> packet)
 
   double distance = CalculateDistance (tag.GetPosition (), mobility->GetPosition ());
 
-  m_jumpDistanceDataTrace (m_node, distance);
+  m_jumpDistanceDataTrace (m_node, distance, packet);
 }
 
 void
@@ -400,48 +640,19 @@ V2vNetDeviceFace::SendFromQueue ()
     }
 
   // If high-priority queue is not empty, send data from it
-  if (m_queue.size () > 0)
-    {
-      Item &item = m_queue.front ();
+  QueueType type = m_queue.size () > 0 ? PRIMARY_QUEUE : LOW_PRIORITY_QUEUE;
 
-      //////////////////////////////
-      TagAndNetDeviceSendImpl (item.m_packet->Copy ());
-      if (item.m_type == HeaderHelper::INTEREST_NDNSIM)
-        {
-          m_txInterest (m_node, item.m_packet, mobility->GetPosition ());
-        }
-      else
-        {
-          m_txData (m_node, item.m_packet, mobility->GetPosition ());
-        }
-      //////////////////////////////
-
-      if (item.m_retxCount < m_maxRetxAttempts)
-        m_retxQueue.push_back (++(item.Gap (m_maxWaitRetransmission)));
-
-      m_totalWaitPeriod -= item.m_gap;
-      m_queue.pop_front ();
+  if (m_aggregation && GetQueue (type).size () > 1)
+    {
+      SendAggregateFromQueue (type, mobility->GetPosition ());
     }
-  else if (m_lowPriorityQueue.size () > 0) // no reason for this check, just for readability
+  else
     {
-      Item &item = m_lowPriorityQueue.front ();
-
       //////////////////////////////
-      TagAndNetDeviceSendImpl (item.m_packet->Copy ());
-      if (item.m_type == HeaderHelper::INTEREST_NDNSIM)
-        {
-          m_txInterest (m_node, item.m_packet, mobility->GetPosition ());
-        }
-      else
-        {
-          m_txData (m_node, item.m_packet, mobility->GetPosition ());
-        }
+      SendQueuedPacket (GetQueue (type).front ().m_packet);
       //////////////////////////////
 
-      if (item.m_retxCount < m_maxRetxAttempts)
-        m_retxQueue.push_back (++(item.Gap (m_maxWaitRetransmission)));
-
-      m_lowPriorityQueue.pop_front ();
+      DequeueTransmitted (type, mobility->GetPosition ());
     }
 
   if (m_queue.size () > 0)
@@ -449,14 +660,111 @@ V2vNetDeviceFace::SendFromQueue ()
   else if (m_lowPriorityQueue.size () > 0)
     m_scheduledSend = Simulator::Schedule (m_lowPriorityQueue.front ().m_gap, &V2vNetDeviceFace::SendFromQueue, this);
 
-  if (!m_retxEvent.IsRunning () && m_retxQueue.size () > 0)
+  ScheduleRetxTick ();
+}
+
+void
+V2vNetDeviceFace::SendAggregateFromQueue (QueueType type, const Vector &position)
+{
+  ItemQueue &queue = GetQueue (type);
+
+  // Pack the front item and the items behind it that are ready, i.e., have already waited
+  // their own gap since they were queued, while they fit into the frame.  Items that are not
+  // ready yet keep their gradient delay and the chance to be cancelled by overhearing
+  V2vAggregateHeader header;
+  Ptr<Packet> frame = Create<Packet> ();
+  uint32_t count = 0;
+  for (ItemHandle handle = queue.begin (); handle != ItemQueue::npos; handle = queue.next (handle))
+    {
+      const Item &item = queue[handle];
+      if (count > 0 && item.m_enqueued + item.m_gap > Simulator::Now ())
+        break;
+
+      Ptr<const Packet> packet = item.m_packet;
+
+      GeoSrcTag srcTag;
+      bool isSrcTag = packet->PeekPacketTag (srcTag);
+
+      GeoScopeTag scopeTag;
+      bool isScopeTag = packet->PeekPacketTag (scopeTag);
+
+      uint32_t frameSize = frame->GetSize () + packet->GetSize () +
+        header.GetSerializedSize () + V2vAggregateHeader::GetEntrySerializedSize (srcTag.HasHeading (), isScopeTag);
+      if (count > 0 &&
+          (frameSize > m_maxAggregateSize || count >= std::numeric_limits<uint8_t>::max ()))
+        break;
+
+      header.AddEntry (packet->GetSize (), isSrcTag, srcTag.GetPosition (), srcTag.GetHeading (),
+                       isScopeTag, scopeTag.GetPosition (), scopeTag.GetRadius ());
+
+      // packet tags do not survive AddAtEnd, but byte tags do: tracers find the aggregated packets by them
+      Ptr<Packet> entry = packet->Copy ();
+      entry->AddByteTag (V2vPacketInfoTag::Get (packet));
+      frame->AddAtEnd (entry);
+      count ++;
+    }
+
+  if (count == 1)
+    {
+      // the front item alone does not leave room for anything else, send it as usual
+      SendQueuedPacket (queue.front ().m_packet);
+    }
+  else
+    {
+      NS_LOG_DEBUG ("Sending " << count << " packets in one frame of " << frame->GetSize () << " bytes");
+
+      frame->AddHeader (header);
+      TagAndNetDeviceSendImpl (frame, AGGREGATE_FRAME_TYPE);
+    }
+
+  for (uint32_t i = 0; i < count; i++)
     {
-      m_retxEvent = Simulator::Schedule (m_retxQueue.front ().m_gap, &V2vNetDeviceFace::ProcessRetx, this);
+      DequeueTransmitted (type, position);
     }
 }
 
+void
+V2vNetDeviceFace::DequeueTransmitted (QueueType type, const Vector &position)
+{
+  Item &item = GetQueue (type).front ();
+
+  if (item.m_type == HeaderHelper::INTEREST_NDNSIM)
+    {
+      m_txInterest (m_node, item.m_packet, position);
+    }
+  else
+    {
+      m_txData (m_node, item.m_packet, position);
+    }
+
+  if (type == PRIMARY_QUEUE)
+    {
+      m_totalWaitPeriod -= item.m_gap;
+    }
+  m_stats.NotifyDequeued (static_cast<V2vFaceStats::Queue> (type), Simulator::Now () - item.m_enqueued);
+  ScheduleRetx (item);
+
+  Dequeue (type);
+}
+
+void
+V2vNetDeviceFace::SendQueuedPacket (Ptr<const Packet> packet)
+{
+  // The only copy on the transmit path: queued packet is shared with the forwarding strategy,
+  // content store, and other queues, while the copy carries per-transmission tags and is owned by MAC
+  Ptr<Packet> copy = packet->Copy ();
+
+  TagAndNetDeviceSendImpl (copy);
+}
+
 void
 V2vNetDeviceFace::TagAndNetDeviceSendImpl (Ptr<Packet> packet)
+{
+  TagAndNetDeviceSendImpl (packet, L3Protocol::ETHERNET_FRAME_TYPE);
+}
+
+void
+V2vNetDeviceFace::TagAndNetDeviceSendImpl (Ptr<Packet> packet, uint16_t protocol)
 {
   Ptr<MobilityModel> mobility = m_node->GetObject<MobilityModel> ();
   if (mobility != 0)
@@ -468,28 +776,73 @@ V2vNetDeviceFace::TagAndNetDeviceSendImpl (Ptr<Packet> packet)
       packet->AddPacketTag (tag);
     }
 
-  NetDeviceFace::SendImpl (packet);
+  if (protocol == L3Protocol::ETHERNET_FRAME_TYPE)
+    {
+      NetDeviceFace::SendImpl (packet);
+    }
+  else
+    {
+      Ptr<NetDevice> device = GetNetDevice ();
+      device->Send (packet, device->GetBroadcast (), protocol);
+    }
 }
 
 
+void
+V2vNetDeviceFace::ScheduleRetx (Item &item)
+{
+  if (item.m_retxCount >= m_maxRetxAttempts)
+    return;
+
+  Item retx = item;
+  retx.Gap (m_maxWaitRetransmission);
+  retx.m_overheard = 0; // only overhearings after the transmission count against the retransmission
+  Enqueue (RETX_QUEUE, ++retx);
+}
+
+void
+V2vNetDeviceFace::ScheduleRetxTick ()
+{
+  if (m_retxQueue.size () == 0)
+    return;
+
+  if (!m_retxPending)
+    {
+      // Retransmissions are paced per face: the front item is released MaxDelayRetransmission
+      // after the previous release (or after it has been queued, if the timer was idle)
+      m_retxPending = true;
+      m_retxDue = Simulator::Now () + m_retxQueue.front ().m_gap;
+    }
+
+  // a stale tick, left by a lazy cancellation, fires earlier and reschedules itself to the due time
+  if (!m_retxEvent.IsRunning ())
+    m_retxEvent = Simulator::Schedule (m_retxDue - Simulator::Now (), &V2vNetDeviceFace::ProcessRetx, this);
+}
+
 void
 V2vNetDeviceFace::ProcessRetx ()
 {
   NS_LOG_FUNCTION (this);
-  NS_ASSERT (m_retxQueue.size () > 0);
 
-  Time gap = GetPriorityQueueGap ();
-  Item item (gap, m_retxQueue.front ().m_packet);
-  item.m_retxCount = m_retxQueue.front ().m_retxCount;
-  m_lowPriorityQueue.push_back (item);
+  // Cancellation does not remove the tick event, so the queue may have been emptied, or refilled
+  // with a later due time, in the meantime
+  if (m_retxPending && m_retxQueue.size () > 0 && m_retxDue <= Simulator::Now ())
+    {
+      m_retxPending = false;
 
-  m_retxQueue.pop_front ();
+      Item item = m_retxQueue.front ();
+      m_stats.NotifyDequeued (V2vFaceStats::RETX_QUEUE, Simulator::Now () - item.m_enqueued);
 
-  if (!m_scheduledSend.IsRunning ())
-    m_scheduledSend = Simulator::Schedule (m_lowPriorityQueue.front ().m_gap, &V2vNetDeviceFace::SendFromQueue, this);
+      item.Gap (GetPriorityQueueGap ());
+      Enqueue (LOW_PRIORITY_QUEUE, item);
 
-  if (m_retxQueue.size () > 0)
-    m_retxEvent = Simulator::Schedule (m_retxQueue.front ().m_gap, &V2vNetDeviceFace::ProcessRetx, this);
+      Dequeue (RETX_QUEUE);
+
+      if (!m_scheduledSend.IsRunning ())
+        m_scheduledSend = Simulator::Schedule (m_lowPriorityQueue.front ().m_gap, &V2vNetDeviceFace::SendFromQueue, this);
+    }
+
+  ScheduleRetxTick ();
 }
 
 void
@@ -501,6 +854,10 @@ V2vNetDeviceFace::RegisterProtocolHandler (ProtocolHandler handler)
 
   m_node->RegisterProtocolHandler (MakeCallback (&V2vNetDeviceFace::ReceiveFromNetDevice, this),
                                    L3Protocol::ETHERNET_FRAME_TYPE, GetNetDevice (), true/*promiscuous mode*/);
+
+  // aggregated frames are accepted even if aggregation is not enabled on this face
+  m_node->RegisterProtocolHandler (MakeCallback (&V2vNetDeviceFace::ReceiveAggregateFromNetDevice, this),
+                                   AGGREGATE_FRAME_TYPE, GetNetDevice (), true/*promiscuous mode*/);
 }
 
 
@@ -509,30 +866,78 @@ void
 V2vNetDeviceFace::ReceiveFromNetDevice (Ptr<NetDevice>,
                                         Ptr<const Packet> p,
                                         uint16_t,
-                                        const Address &,
+                                        const Address &from,
                                         const Address &,
                                         NetDevice::PacketType)
 {
   // NS_LOG_FUNCTION (this << p);
 
-  HeaderHelper::Type packetType = HeaderHelper::GetNdnHeaderType (p);
-  if (packetType == HeaderHelper::INTEREST_CCNB ||
-      packetType == HeaderHelper::INTEREST_NDNSIM)
-    {
-      packetType = HeaderHelper::INTEREST_NDNSIM;
-    }
-  else if (packetType == HeaderHelper::CONTENT_OBJECT_CCNB ||
-           packetType == HeaderHelper::CONTENT_OBJECT_NDNSIM)
+  UpdateNeighbor (from, p);
+  ProcessReceivedPacket (p);
+}
+
+// callback
+void
+V2vNetDeviceFace::ReceiveAggregateFromNetDevice (Ptr<NetDevice>,
+                                                 Ptr<const Packet> p,
+                                                 uint16_t,
+                                                 const Address &from,
+                                                 const Address &,
+                                                 NetDevice::PacketType)
+{
+  // NS_LOG_FUNCTION (this << p);
+
+  UpdateNeighbor (from, p);
+
+  Ptr<Packet> frame = p->Copy (); // keeps GeoTransmissionTag of the frame
+  V2vAggregateHeader header;
+  frame->RemoveHeader (header);
+
+  const V2vAggregateHeader::EntryList &entries = header.GetEntries ();
+  uint32_t offset = 0;
+  for (V2vAggregateHeader::EntryList::const_iterator entry = entries.begin (); entry != entries.end (); entry++)
     {
-      packetType = HeaderHelper::CONTENT_OBJECT_NDNSIM;
+      NS_ASSERT (offset + entry->m_size <= frame->GetSize ());
+
+      Ptr<Packet> packet = frame->CreateFragment (offset, entry->m_size);
+      offset += entry->m_size;
+      packet->RemoveAllByteTags (); // they describe the aggregated frame (see SendAggregateFromQueue)
+
+      if (entry->m_hasSrcPosition)
+        {
+          GeoSrcTag srcTag;
+          srcTag.SetPosition (entry->m_srcPosition);
+          srcTag.SetHeading (entry->m_srcHeading);
+          packet->AddPacketTag (srcTag);
+        }
+
+      if (entry->m_hasScope)
+        {
+          GeoScopeTag scopeTag;
+          scopeTag.SetPosition (entry->m_scopeCenter);
+          scopeTag.SetRadius (entry->m_scopeRadius);
+          packet->AddPacketTag (scopeTag);
+        }
+
+      ProcessReceivedPacket (packet);
     }
-  else
+}
+
+void
+V2vNetDeviceFace::UpdateNeighbor (const Address &from, Ptr<const Packet> frame)
+{
+  GeoTransmissionTag transmissionTag;
+  if (frame->PeekPacketTag (transmissionTag))
     {
-      NS_FATAL_ERROR ("Unknown NDN header type");
+      m_neighbors.Update (from, transmissionTag.GetPosition ());
     }
+}
 
-  Ptr<const Name> name = HeaderHelper::GetName (p); // not efficient (extra deserialization), but it is the only way for now
-  NS_ASSERT (name != 0);
+void
+V2vNetDeviceFace::ProcessReceivedPacket (Ptr<const Packet> p)
+{
+  V2vPacketInfoTag info = V2vPacketInfoTag::Get (p); // parsed only if sender did not tag the packet
+  HeaderHelper::Type packetType = info.GetType ();
 
   GeoSrcTag srcTag;
   GeoTransmissionTag transmissionTag;
@@ -544,124 +949,113 @@ V2vNetDeviceFace::ReceiveFromNetDevice (Ptr<NetDevice>,
 
   NS_LOG_DEBUG ("SANITY CHECK: " << isSrcTag << ", " << isTransmissionTag << ", " << mobility);
 
-  //   src  -----   <transmission>  ---- <mobility>
-  bool needToCancel = true;
-  if (mobility && isSrcTag && isTransmissionTag)
-    {
-      NS_LOG_DEBUG ("Check distances:" << CalculateDistance (srcTag.GetPosition (), transmissionTag.GetPosition ()) << " <? " << CalculateDistance (srcTag.GetPosition (), mobility->GetPosition ()));
-      if (CalculateDistance (srcTag.GetPosition (), transmissionTag.GetPosition ())
-          <
-          CalculateDistance (srcTag.GetPosition (), mobility->GetPosition ()))
-        {
-          needToCancel = false;
-        }
-    }
+  V2vSuppressionPolicy::Overheard overheard;
+  overheard.m_hasSource = isSrcTag;
+  overheard.m_source = srcTag.GetPosition ();
+  overheard.m_hasTransmitter = isTransmissionTag;
+  overheard.m_transmitter = transmissionTag.GetPosition ();
+  overheard.m_hasPosition = mobility != 0;
+  if (mobility != 0)
+    overheard.m_position = mobility->GetPosition ();
 
   bool cancelled = false;
-  ItemQueue::iterator item = m_lowPriorityQueue.begin ();
-  while (item != m_lowPriorityQueue.end ())
+  bool ignored = false;
+  ItemIndex::iterator found = m_index.find (info.GetNameId ());
+  if (found != m_index.end ())
     {
-      NS_ASSERT (item->m_name != 0);
-
-      if ((packetType==HeaderHelper::CONTENT_OBJECT_NDNSIM || item->m_type == packetType) && *item->m_name == *name)
+      // the entry exists only while something with the name is queued
+      if (isTransmissionTag)
         {
-          cancelled = item->m_type == packetType;
-
-          if (needToCancel)
-            {
-              ItemQueue::iterator tmp = item;
-              tmp ++;
-
-              NS_LOG_INFO ("Canceling ContentObject with name " << name->GetLastComponent () << ", which is scheduled for low-priority transmission");
-              m_cancellingData (m_node, item->m_packet);
-
-              m_lowPriorityQueue.erase (item);
-              if (m_queue.size () + m_lowPriorityQueue.size () == 0)
-                {
-                  Simulator::Remove (m_scheduledSend);
-                }
-
-              item = tmp;
-            }
-          else
-            {
-              item ++;
-            }
+          found->second.m_transmitters.push_back (transmissionTag.GetPosition ());
         }
-      else
-        item ++;
-    }
+      overheard.m_transmitters = &found->second.m_transmitters;
 
-  item = m_queue.begin ();
-  while (item != m_queue.end ())
-    {
-      NS_ASSERT (item->m_name != 0);
+      // the same order of queues as the items would have been checked one by one
+      static const QueueType queues[] = { LOW_PRIORITY_QUEUE, PRIMARY_QUEUE, RETX_QUEUE };
 
-      if ((packetType==HeaderHelper::CONTENT_OBJECT_NDNSIM || item->m_type == packetType) && *item->m_name == *name)
+      for (uint32_t i = 0; i < sizeof (queues) / sizeof (queues[0]); i++)
         {
-          cancelled = item->m_type == packetType;
+          // Erase drops the entry together with the last queued item with the name
+          found = m_index.find (info.GetNameId ());
+          if (found == m_index.end ())
+            break;
 
-          if (needToCancel)
-            {
-              ItemQueue::iterator tmp = item;
-              tmp ++;
+          QueueType queueType = queues[i];
+          ItemQueue &queue = GetQueue (queueType);
 
-              NS_LOG_INFO ("Canceling ContentObject with name " << name->GetLastComponent () << ", which is scheduled for transmission");
-              m_cancellingData (m_node, item->m_packet);
+          ItemHandle handle = found->second.m_head[queueType];
+          while (handle != ItemQueue::npos)
+            {
+              Item &item = queue[handle];
+              ItemHandle next = item.m_nextSameName;
 
-              m_totalWaitPeriod -= item->m_gap;
-              m_queue.erase (item);
-              if (m_queue.size () == 0)
+              if (packetType != HeaderHelper::CONTENT_OBJECT_NDNSIM && item.m_type != packetType)
                 {
-                  Simulator::Remove (m_scheduledSend);
+                  handle = next;
+                  continue;
                 }
 
-              item = tmp;
-            }
-          else
-            item ++;
-        }
-      else
-        item ++;
-    }
+              cancelled = item.m_type == packetType;
 
-  item = m_retxQueue.begin ();
-  while (item != m_retxQueue.end ())
-    {
-      NS_ASSERT (item->m_name != 0);
-
-      if ((packetType==HeaderHelper::CONTENT_OBJECT_NDNSIM || item->m_type == packetType) && *item->m_name == *name)
-        {
-          cancelled = item->m_type == packetType;
-          if (needToCancel)
-            {
-              ItemQueue::iterator tmp = item;
-              tmp ++;
-
-              NS_LOG_INFO ("Canceling ContentObject with name " << name->GetLastComponent () << ", which is planned for retransmission");
-              m_cancellingData (m_node, item->m_packet);
+              item.m_overheard ++;
+              overheard.m_count = item.m_overheard;
+              if (!m_suppressionPolicy->ShouldCancel (overheard))
+                {
+                  m_stats.NotifyCancelled (V2vFaceStats::CANCEL_IGNORED);
+                  ignored = true;
+                  handle = next;
+                  continue;
+                }
 
-              m_retxQueue.erase (item);
-              if (m_retxQueue.size () == 0)
+              m_cancellingData (m_node, item.m_packet);
+              switch (queueType)
                 {
-                  NS_LOG_INFO ("Canceling the retx processing event");
-                  Simulator::Remove (m_retxEvent);
+                case LOW_PRIORITY_QUEUE:
+                  NS_LOG_INFO ("Canceling ContentObject with name " << info.GetName ()->GetLastComponent () << ", which is scheduled for low-priority transmission");
+                  m_stats.NotifyCancelled (V2vFaceStats::CANCEL_LOW_PRIORITY);
+                  Erase (LOW_PRIORITY_QUEUE, handle);
+                  if (m_queue.size () + m_lowPriorityQueue.size () == 0)
+                    {
+                      Simulator::Remove (m_scheduledSend);
+                    }
+                  break;
+
+                case PRIMARY_QUEUE:
+                  NS_LOG_INFO ("Canceling ContentObject with name " << info.GetName ()->GetLastComponent () << ", which is scheduled for transmission");
+                  m_stats.NotifyCancelled (V2vFaceStats::CANCEL_PRIMARY);
+                  m_totalWaitPeriod -= item.m_gap;
+                  Erase (PRIMARY_QUEUE, handle);
+                  if (m_queue.size () == 0)
+                    {
+                      Simulator::Remove (m_scheduledSend);
+                    }
+                  break;
+
+                case RETX_QUEUE:
+                  NS_LOG_INFO ("Canceling ContentObject with name " << info.GetName ()->GetLastComponent () << ", which is planned for retransmission");
+                  m_stats.NotifyCancelled (V2vFaceStats::CANCEL_RETX);
+                  Erase (RETX_QUEUE, handle);
+                  if (m_retxQueue.size () == 0)
+                    {
+                      // retx tick event is not removed, it will find nothing to do (lazy cancellation)
+                      m_retxPending = false;
+                    }
+                  break;
+
+                default:
+                  NS_FATAL_ERROR ("Unknown queue type");
                 }
 
-              item = tmp;
+              handle = next;
             }
-          else
-            item ++;
         }
-      else
-        item ++;
     }
 
   if (cancelled)
     {
-      if (!needToCancel)
+      if (ignored)
         {
-          NS_LOG_DEBUG ("Ignoring cancellation from a backwards node");
+          NS_LOG_DEBUG ("Suppression policy decided to keep (some of) the queued transmissions");
         }
       NS_LOG_DEBUG ("Cancelled");
       return;
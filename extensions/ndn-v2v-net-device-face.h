@@ -29,6 +29,13 @@
 #include "ns3/ndn-net-device-face.h"
 #include "ns3/ndn-header-helper.h"
 
+#include "pooled-list.h"
+#include "v2v-neighbor-table.h"
+#include "v2v-face-stats.h"
+
+#include <vector>
+#include <boost/unordered_map.hpp>
+
 namespace ns3 {
 
 class Vector3D;
@@ -36,7 +43,8 @@ typedef Vector3D Vector;
 
 namespace ndn {
 
-class Name;
+class V2vDelayPolicy;
+class V2vSuppressionPolicy;
 
 /**
  * \ingroup ndn-face
@@ -70,13 +78,22 @@ public:
   V2vNetDeviceFace (Ptr<Node> node, const Ptr<NetDevice> &netDevice);
   virtual ~V2vNetDeviceFace();
 
+  /// \brief Protocol number of the link-layer frames that aggregate several NDN packets
+  static const uint16_t AGGREGATE_FRAME_TYPE;
+
   // from CcnxFace
   virtual void
-  SendLowPriority (Ptr<Packet> p);
+  SendLowPriority (Ptr<const Packet> p);
 
   virtual void
   RegisterProtocolHandler (ProtocolHandler handler);
 
+  /**
+   * \brief Get queueing, cancellation, and drop statistics collected by the face
+   */
+  const V2vFaceStats &
+  GetStats () const;
+
 protected:
   // from ndn::NetDeviceFace
   virtual bool
@@ -99,6 +116,19 @@ private:
                         const Address &to,
                         NetDevice::PacketType packetType);
 
+  /// \brief callback from lower layers for aggregated frames (see V2vAggregateHeader)
+  void
+  ReceiveAggregateFromNetDevice (Ptr<NetDevice> device,
+                                 Ptr<const Packet> p,
+                                 uint16_t protocol,
+                                 const Address &from,
+                                 const Address &to,
+                                 NetDevice::PacketType packetType);
+
+  /// \brief Cancel queued transmissions of the overheard packet and pass it up, unless it was a duplicate
+  void
+  ProcessReceivedPacket (Ptr<const Packet> p);
+
   void
   SendFromQueue ();
 
@@ -114,11 +144,46 @@ private:
   Time
   GetMaxDelayLowPriority () const;
 
+  void
+  SetDelayPolicy (const std::string &typeId);
+
+  std::string
+  GetDelayPolicy () const;
+
+  void
+  SetSuppressionPolicy (const std::string &typeId);
+
+  std::string
+  GetSuppressionPolicy () const;
+
+  void
+  SetNeighborTimeout (const Time &value);
+
+  Time
+  GetNeighborTimeout () const;
+
+  /// \brief Get current jitter window (MaxDelay, or density-based window in the adaptive mode)
+  Time
+  GetJitterWindow ();
+
+  /// \brief Get current gradient normalization distance (MaxDistance, or effective range in the adaptive mode)
+  double
+  GetNormalizationDistance ();
+
+  /// \brief Learn position of the transmitter of the overheard frame
+  void
+  UpdateNeighbor (const Address &from, Ptr<const Packet> frame);
+
+  /// \brief Set the release time of the front retransmission (unless already set) and make sure the retx timer tick is scheduled
+  void
+  ScheduleRetxTick ();
+
+  /// \brief Retx timer tick: move the front retransmission to the low-priority queue, if it is due
   void
   ProcessRetx ();
 
   Time
-  GetPriorityQueueGap () const;
+  GetPriorityQueueGap ();
 
   void
   NotifyJumpDistanceInterestTrace (const Ptr<const Packet> packet);
@@ -126,14 +191,21 @@ private:
   void
   NotifyJumpDistanceDataTrace (const Ptr<const Packet> packet);
 
+  /// \brief Transmit copy of the queued (shared) packet
+  void
+  SendQueuedPacket (Ptr<const Packet> packet);
+
   void
   TagAndNetDeviceSendImpl (Ptr<Packet> packet);
 
+  void
+  TagAndNetDeviceSendImpl (Ptr<Packet> packet, uint16_t protocol);
+
 private:
   struct Item
   {
-    Item (const Time &_gap, const Ptr<Packet> &_packet);
-    Item (const Item &item);
+    Item ();
+    Item (const Time &_gap, const Ptr<const Packet> &_packet);
 
     Item &
     operator ++ ();
@@ -142,12 +214,74 @@ private:
     Gap (const Time &time);
 
     Time m_gap;
-    Ptr<Packet> m_packet;
+    Time m_enqueued; ///< \brief when the item was put into its current queue
+    Ptr<const Packet> m_packet;
+    uint32_t m_nameId; ///< \brief id of the interned name (see V2vPacketInfoTag)
     HeaderHelper::Type m_type;
-    Ptr<const Name> m_name;
     uint32_t m_retxCount;
+    uint32_t m_overheard; ///< \brief how many times the name has been overheard since the item was (re)scheduled
+
+    // links between items with the same name in the same queue (see IndexEntry)
+    uint32_t m_prevSameName;
+    uint32_t m_nextSameName;
   };
-  typedef std::list<Item> ItemQueue;
+  typedef PooledList<Item> ItemQueue;
+  typedef ItemQueue::handle ItemHandle;
+
+  enum QueueType
+    {
+      PRIMARY_QUEUE = 0,
+      LOW_PRIORITY_QUEUE,
+      RETX_QUEUE,
+
+      QUEUE_TYPE_COUNT
+    };
+
+  /**
+   * \brief Per-name entry of the secondary index (keyed by interned name id)
+   *
+   * For each of the queues keeps the first and the last item with the name, the rest
+   * of the items are chained through Item::m_prevSameName/m_nextSameName in the queue order.
+   * The entry exists only while at least one item with the name is queued
+   */
+  struct IndexEntry
+  {
+    IndexEntry ();
+
+    ItemHandle m_head[QUEUE_TYPE_COUNT];
+    ItemHandle m_tail[QUEUE_TYPE_COUNT];
+
+    /// \brief Positions of the transmitters of the name overheard while the name is queued (see V2vCoverageSuppressionPolicy)
+    std::vector<Vector> m_transmitters;
+  };
+  typedef boost::unordered_map<uint32_t, IndexEntry> ItemIndex;
+
+  ItemQueue &
+  GetQueue (QueueType type);
+
+  /// \brief Append item to the queue and register it in the secondary index
+  void
+  Enqueue (QueueType type, const Item &item);
+
+  /// \brief Remove item from the queue and from the secondary index
+  void
+  Erase (QueueType type, ItemHandle item);
+
+  /// \brief Remove the front item of the queue and its entry in the secondary index
+  void
+  Dequeue (QueueType type);
+
+  /// \brief Put copy of the just transmitted item to the retx queue (if retx attempts are not exhausted)
+  void
+  ScheduleRetx (Item &item);
+
+  /// \brief Fire tx trace for the just transmitted front item of the queue, schedule its retx, and dequeue it
+  void
+  DequeueTransmitted (QueueType type, const Vector &position);
+
+  /// \brief Send as many items from the front of the queue as fit into one aggregated frame
+  void
+  SendAggregateFromQueue (QueueType type, const Vector &position);
 
   EventId m_scheduledSend;
 
@@ -161,25 +295,49 @@ private:
   // Low-priority queue (for pushing Interest and ContentObject packets)
   Time m_maxWaitLowPriority;
   double m_maxDistance;
+  Ptr<V2vDelayPolicy> m_delayPolicy;
   ItemQueue m_lowPriorityQueue;
 
-  // Retransmission queue for low-priority pushing
+  // Retransmission queue for low-priority pushing.  Retransmissions are paced (one release per
+  // MaxDelayRetransmission), so there is still one retx event per release; cancellation is lazy
+  // and does not remove the event from the scheduler
   EventId m_retxEvent;
   Time m_maxWaitRetransmission;
+  bool m_retxPending; ///< \brief release time of the front retransmission is set
+  Time m_retxDue;
   ItemQueue m_retxQueue;
   uint32_t m_maxRetxAttempts;
 
+  // Secondary index to find queued items by name without scanning the queues
+  ItemIndex m_index;
+
+  // Decides which queued items are cancelled when their name is overheard
+  Ptr<V2vSuppressionPolicy> m_suppressionPolicy;
+
+  // Density-adaptive delays
+  bool m_adaptiveDelays;
+  Time m_jitterSlot;
+  V2vNeighborTable m_neighbors;
+
+  V2vFaceStats m_stats;
+
+  // Link-layer aggregation of queued packets
+  bool m_aggregation;
+  uint32_t m_maxAggregateSize;
+
   TracedCallback<double, double> m_waitingTimeVsDistanceDataTrace;
   TracedCallback<double, double> m_waitingTimeVsDistanceInterestTrace;
 
-  TracedCallback<Ptr<const Node>, double> m_jumpDistanceDataTrace;
-  TracedCallback<Ptr<const Node>, double> m_jumpDistanceInterestTrace;
+  TracedCallback<Ptr<const Node>, double, Ptr<const Packet> > m_jumpDistanceDataTrace;
+  TracedCallback<Ptr<const Node>, double, Ptr<const Packet> > m_jumpDistanceInterestTrace;
 
   TracedCallback<Ptr<Node>, Ptr<const Packet>, const Vector&> m_txData;
   TracedCallback<Ptr<Node>, Ptr<const Packet>, const Vector&> m_txInterest;
 
   TracedCallback<Ptr<Node>, Ptr<const Packet> > m_cancellingData;
   TracedCallback<Ptr<Node>, Ptr<const Packet> > m_cancellingInterest;
+
+  TracedCallback<Ptr<Node>, Ptr<const Packet> > m_drop;
 };
 
 } // namespace ndn
@@ -0,0 +1,225 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef POOLED_LIST_H
+#define POOLED_LIST_H
+
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <stdint.h>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief Doubly-linked FIFO list with nodes allocated from a pool
+ *
+ * Nodes are kept in a vector and linked by indexes (handles).  Removed nodes are put on
+ * the free list and reused, so once the pool has grown to the peak list size (or was
+ * reserved upfront) push_back/erase do not allocate memory.
+ *
+ * Handles stay valid until the element is removed, which allows removal from the middle
+ * of the list (e.g., on cancellation) in O(1).
+ */
+template<class T>
+class PooledList
+{
+public:
+  typedef uint32_t handle;
+
+  /// \brief Invalid handle
+  static const handle npos = 0xFFFFFFFF;
+
+  PooledList ()
+    : m_head (npos)
+    , m_tail (npos)
+    , m_free (npos)
+    , m_size (0)
+  {
+  }
+
+  /**
+   * \brief Preallocate pool for \p capacity elements
+   */
+  void
+  reserve (size_t capacity)
+  {
+    m_nodes.reserve (capacity);
+  }
+
+  size_t
+  capacity () const
+  {
+    return m_nodes.capacity ();
+  }
+
+  size_t
+  size () const
+  {
+    return m_size;
+  }
+
+  bool
+  empty () const
+  {
+    return m_size == 0;
+  }
+
+  /**
+   * \brief Append copy of the element to the end of the list
+   * \returns handle of the new element
+   */
+  handle
+  push_back (const T &value)
+  {
+    handle node = m_free;
+    if (node != npos)
+      {
+        m_free = m_nodes[node].m_next;
+        m_nodes[node].m_value = value;
+      }
+    else
+      {
+        node = m_nodes.size ();
+        m_nodes.push_back (Node (value));
+      }
+
+    m_nodes[node].m_prev = m_tail;
+    m_nodes[node].m_next = npos;
+
+    if (m_tail != npos)
+      m_nodes[m_tail].m_next = node;
+    else
+      m_head = node;
+
+    m_tail = node;
+    m_size ++;
+
+    return node;
+  }
+
+  /**
+   * \brief Remove element from the list and return its node to the pool
+   */
+  void
+  erase (handle node)
+  {
+    assert (node < m_nodes.size () && m_size > 0);
+
+    Node &item = m_nodes[node];
+    if (item.m_prev != npos)
+      m_nodes[item.m_prev].m_next = item.m_next;
+    else
+      m_head = item.m_next;
+
+    if (item.m_next != npos)
+      m_nodes[item.m_next].m_prev = item.m_prev;
+    else
+      m_tail = item.m_prev;
+
+    item.m_value = T (); // release whatever resources element holds
+    item.m_prev = npos;
+    item.m_next = m_free;
+    m_free = node;
+
+    m_size --;
+  }
+
+  void
+  pop_front ()
+  {
+    erase (m_head);
+  }
+
+  T &
+  front ()
+  {
+    assert (m_head != npos);
+    return m_nodes[m_head].m_value;
+  }
+
+  const T &
+  front () const
+  {
+    assert (m_head != npos);
+    return m_nodes[m_head].m_value;
+  }
+
+  /**
+   * \brief Get handle of the first element (npos if list is empty)
+   */
+  handle
+  begin () const
+  {
+    return m_head;
+  }
+
+  /**
+   * \brief Get handle of the element following \p node (npos if \p node is the last one)
+   */
+  handle
+  next (handle node) const
+  {
+    return m_nodes[node].m_next;
+  }
+
+  T &
+  operator[] (handle node)
+  {
+    return m_nodes[node].m_value;
+  }
+
+  const T &
+  operator[] (handle node) const
+  {
+    return m_nodes[node].m_value;
+  }
+
+private:
+  struct Node
+  {
+    Node (const T &value)
+      : m_value (value)
+      , m_prev (npos)
+      , m_next (npos)
+    {
+    }
+
+    T m_value;
+    handle m_prev;
+    handle m_next;
+  };
+
+  std::vector<Node> m_nodes;
+  handle m_head;
+  handle m_tail;
+  handle m_free;
+  size_t m_size;
+};
+
+template<class T>
+const typename PooledList<T>::handle PooledList<T>::npos;
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // POOLED_LIST_H
@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-aggregate-header.h"
+
+#include <cstring>
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vAggregateHeader);
+
+static const uint8_t FLAG_SRC_POSITION = 0x01;
+static const uint8_t FLAG_SCOPE = 0x02;
+static const uint8_t FLAG_HEADING = 0x04;
+
+static bool
+IsHeadingSet (const Vector &heading)
+{
+  return heading.x != 0 || heading.y != 0;
+}
+
+static void
+WriteDouble (Buffer::Iterator &i, double value)
+{
+  uint64_t bits;
+  std::memcpy (&bits, &value, sizeof (bits));
+  i.WriteHtonU64 (bits);
+}
+
+static double
+ReadDouble (Buffer::Iterator &i)
+{
+  uint64_t bits = i.ReadNtohU64 ();
+  double value;
+  std::memcpy (&value, &bits, sizeof (value));
+  return value;
+}
+
+TypeId
+V2vAggregateHeader::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::V2vAggregateHeader")
+    .SetParent<Header> ()
+    .AddConstructor<V2vAggregateHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+V2vAggregateHeader::GetInstanceTypeId () const
+{
+  return V2vAggregateHeader::GetTypeId ();
+}
+
+V2vAggregateHeader::V2vAggregateHeader ()
+{
+}
+
+void
+V2vAggregateHeader::AddEntry (uint16_t size, bool hasSrcPosition, const Vector &srcPosition, const Vector &srcHeading,
+                              bool hasScope, const Vector &scopeCenter, double scopeRadius)
+{
+  Entry entry;
+  entry.m_size = size;
+  entry.m_hasSrcPosition = hasSrcPosition;
+  entry.m_srcPosition = srcPosition;
+  entry.m_srcHeading = srcHeading;
+  entry.m_hasScope = hasScope;
+  entry.m_scopeCenter = scopeCenter;
+  entry.m_scopeRadius = scopeRadius;
+
+  m_entries.push_back (entry);
+}
+
+const V2vAggregateHeader::EntryList &
+V2vAggregateHeader::GetEntries () const
+{
+  return m_entries;
+}
+
+uint32_t
+V2vAggregateHeader::GetEntrySerializedSize (bool hasHeading, bool hasScope)
+{
+  // size, flags, and x/y of the source position (same as GeoTag), optionally followed
+  // by x/y of the propagation heading and x/y of the scope center and scope radius (same as GeoScopeTag)
+  return 2 + 1 + 2 * sizeof (double) +
+    (hasHeading ? 2 * sizeof (double) : 0) +
+    (hasScope ? 3 * sizeof (double) : 0);
+}
+
+uint32_t
+V2vAggregateHeader::GetSerializedSize () const
+{
+  uint32_t size = 1;
+  for (EntryList::const_iterator entry = m_entries.begin (); entry != m_entries.end (); entry++)
+    {
+      size += GetEntrySerializedSize (IsHeadingSet (entry->m_srcHeading), entry->m_hasScope);
+    }
+  return size;
+}
+
+void
+V2vAggregateHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+
+  i.WriteU8 (static_cast<uint8_t> (m_entries.size ()));
+  for (EntryList::const_iterator entry = m_entries.begin (); entry != m_entries.end (); entry++)
+    {
+      i.WriteHtonU16 (entry->m_size);
+      bool hasHeading = IsHeadingSet (entry->m_srcHeading);
+      i.WriteU8 ((entry->m_hasSrcPosition ? FLAG_SRC_POSITION : 0) |
+                 (entry->m_hasScope ? FLAG_SCOPE : 0) |
+                 (hasHeading ? FLAG_HEADING : 0));
+      WriteDouble (i, entry->m_srcPosition.x);
+      WriteDouble (i, entry->m_srcPosition.y);
+      if (hasHeading)
+        {
+          WriteDouble (i, entry->m_srcHeading.x);
+          WriteDouble (i, entry->m_srcHeading.y);
+        }
+      if (entry->m_hasScope)
+        {
+          WriteDouble (i, entry->m_scopeCenter.x);
+          WriteDouble (i, entry->m_scopeCenter.y);
+          WriteDouble (i, entry->m_scopeRadius);
+        }
+    }
+}
+
+uint32_t
+V2vAggregateHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+
+  m_entries.clear ();
+  uint8_t count = i.ReadU8 ();
+  for (uint8_t n = 0; n < count; n++)
+    {
+      Entry entry;
+      entry.m_size = i.ReadNtohU16 ();
+      uint8_t flags = i.ReadU8 ();
+      entry.m_hasSrcPosition = (flags & FLAG_SRC_POSITION) != 0;
+      entry.m_hasScope = (flags & FLAG_SCOPE) != 0;
+      entry.m_srcPosition.x = ReadDouble (i);
+      entry.m_srcPosition.y = ReadDouble (i);
+      if (flags & FLAG_HEADING)
+        {
+          entry.m_srcHeading.x = ReadDouble (i);
+          entry.m_srcHeading.y = ReadDouble (i);
+        }
+      entry.m_scopeRadius = 0;
+      if (entry.m_hasScope)
+        {
+          entry.m_scopeCenter.x = ReadDouble (i);
+          entry.m_scopeCenter.y = ReadDouble (i);
+          entry.m_scopeRadius = ReadDouble (i);
+        }
+
+      m_entries.push_back (entry);
+    }
+
+  return GetSerializedSize ();
+}
+
+void
+V2vAggregateHeader::Print (std::ostream &os) const
+{
+  os << "Aggregate (";
+  for (EntryList::const_iterator entry = m_entries.begin (); entry != m_entries.end (); entry++)
+    {
+      if (entry != m_entries.begin ())
+        os << ", ";
+      os << entry->m_size;
+    }
+  os << ")";
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_AGGREGATE_HEADER_H
+#define V2V_AGGREGATE_HEADER_H
+
+#include "ns3/header.h"
+#include "ns3/vector.h"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief Header of the link-layer frame that aggregates several NDN packets
+ *
+ * Header lists sizes of the aggregated packets (packets themselves follow the header
+ * back to back).  Packet tags do not survive aggregation, so position of the original
+ * data source and propagation heading (GeoSrcTag), and geographic scope of the packet (GeoScopeTag, if any) are
+ * carried in the header explicitly.
+ */
+class V2vAggregateHeader : public Header
+{
+public:
+  struct Entry
+  {
+    uint16_t m_size;
+    bool m_hasSrcPosition;
+    Vector m_srcPosition;
+    Vector m_srcHeading;
+    bool m_hasScope;
+    Vector m_scopeCenter;
+    double m_scopeRadius;
+  };
+  typedef std::vector<Entry> EntryList;
+
+  static TypeId
+  GetTypeId ();
+
+  virtual TypeId
+  GetInstanceTypeId () const;
+
+  V2vAggregateHeader ();
+
+  /**
+   * \brief Add description of the next aggregated packet
+   */
+  void
+  AddEntry (uint16_t size, bool hasSrcPosition, const Vector &srcPosition, const Vector &srcHeading,
+            bool hasScope, const Vector &scopeCenter, double scopeRadius);
+
+  const EntryList &
+  GetEntries () const;
+
+  /**
+   * \brief Get size that each additional entry adds to the serialized header
+   *
+   * \param hasHeading whether entry carries propagation heading of the packet
+   * \param hasScope whether entry carries geographic scope of the packet
+   */
+  static uint32_t
+  GetEntrySerializedSize (bool hasHeading, bool hasScope);
+
+  // from Header
+  virtual uint32_t
+  GetSerializedSize () const;
+
+  virtual void
+  Serialize (Buffer::Iterator start) const;
+
+  virtual uint32_t
+  Deserialize (Buffer::Iterator start);
+
+  virtual void
+  Print (std::ostream &os) const;
+
+private:
+  EntryList m_entries;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_AGGREGATE_HEADER_H
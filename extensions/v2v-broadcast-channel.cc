@@ -0,0 +1,243 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-broadcast-channel.h"
+#include "v2v-broadcast-net-device.h"
+#include "v2v-remote-frame-header.h"
+
+#include "ns3/mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+
+#ifdef HAVE_NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif
+
+#include <cmath>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.V2vBroadcastChannel");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vBroadcastChannel);
+
+static const double SPEED_OF_LIGHT = 299792458.0;
+
+// reception probability at the cutoff distance is below 0.1%
+static const double CUTOFF_SLOPES = 7.0;
+
+TypeId
+V2vBroadcastChannel::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::V2vBroadcastChannel")
+    .SetParent<Channel> ()
+    .AddConstructor<V2vBroadcastChannel> ()
+
+    .AddAttribute ("ReceptionRange", "Distance at which frame is received with 50% probability",
+                   DoubleValue (250.0),
+                   MakeDoubleAccessor (&V2vBroadcastChannel::m_receptionRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("ReceptionSlope", "Width of the transition from reliable reception to no reception (the larger, the smoother)",
+                   DoubleValue (15.0),
+                   MakeDoubleAccessor (&V2vBroadcastChannel::m_receptionSlope),
+                   MakeDoubleChecker<double> (0.001))
+    .AddAttribute ("GridUpdateInterval", "How often positions of the devices in the grid index are updated",
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&V2vBroadcastChannel::m_gridUpdateInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("GridSlack", "Maximum distance device can move between grid updates",
+                   DoubleValue (100.0),
+                   MakeDoubleAccessor (&V2vBroadcastChannel::m_gridSlack),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("ReceptionDelay", "Delay between the arrival of the frame and the start of its reception, in addition to the propagation delay "
+                   "(by default, 802.11a slot time, which accounts for the carrier sensing and MAC processing delays of the receiver). "
+                   "In MPI mode, it is a part of the lookahead between ranks",
+                   TimeValue (MicroSeconds (9)),
+                   MakeTimeAccessor (&V2vBroadcastChannel::m_receptionDelay),
+                   MakeTimeChecker ())
+    ;
+  return tid;
+}
+
+V2vBroadcastChannel::V2vBroadcastChannel ()
+  : m_cellSize (0)
+  , m_nextGridUpdate (Seconds (0))
+{
+}
+
+V2vBroadcastChannel::~V2vBroadcastChannel ()
+{
+}
+
+void
+V2vBroadcastChannel::DoDispose ()
+{
+  m_devices.clear ();
+  m_mobility.clear ();
+  m_grid.clear ();
+
+  Channel::DoDispose ();
+}
+
+void
+V2vBroadcastChannel::Add (Ptr<V2vBroadcastNetDevice> device)
+{
+  m_devices.push_back (device);
+  m_mobility.push_back (0); // mobility model may not be installed yet, it is looked up on the grid update
+
+  m_nextGridUpdate = Seconds (0); // force update of the grid
+}
+
+uint32_t
+V2vBroadcastChannel::GetNDevices () const
+{
+  return m_devices.size ();
+}
+
+Ptr<NetDevice>
+V2vBroadcastChannel::GetDevice (uint32_t i) const
+{
+  return m_devices[i];
+}
+
+double
+V2vBroadcastChannel::GetReceptionProbability (double distance) const
+{
+  return 1.0 / (1.0 + std::exp ((distance - m_receptionRange) / m_receptionSlope));
+}
+
+double
+V2vBroadcastChannel::GetCutoffDistance () const
+{
+  return m_receptionRange + CUTOFF_SLOPES * m_receptionSlope;
+}
+
+Time
+V2vBroadcastChannel::GetDelay (double distance) const
+{
+  return m_receptionDelay + Seconds (distance / SPEED_OF_LIGHT);
+}
+
+V2vBroadcastChannel::Cell
+V2vBroadcastChannel::GetCell (const Vector &position) const
+{
+  return Cell (static_cast<int64_t> (std::floor (position.x / m_cellSize)),
+               static_cast<int64_t> (std::floor (position.y / m_cellSize)));
+}
+
+void
+V2vBroadcastChannel::UpdateGrid ()
+{
+  if (Simulator::Now () < m_nextGridUpdate)
+    return;
+
+  m_nextGridUpdate = Simulator::Now () + m_gridUpdateInterval;
+  m_cellSize = GetCutoffDistance () + m_gridSlack;
+
+  m_grid.clear ();
+  for (uint32_t i = 0; i < m_devices.size (); i++)
+    {
+      if (m_mobility[i] == 0)
+        {
+          m_mobility[i] = m_devices[i]->GetNode ()->GetObject<MobilityModel> ();
+          NS_ASSERT_MSG (m_mobility[i] != 0, "Mobility model has to be installed on the node");
+        }
+
+      m_grid[GetCell (m_mobility[i]->GetPosition ())].push_back (i);
+    }
+}
+
+void
+V2vBroadcastChannel::Transmit (Ptr<V2vBroadcastNetDevice> sender, Ptr<const Packet> packet, uint16_t protocol, const Time &duration)
+{
+  UpdateGrid ();
+
+  Ptr<MobilityModel> senderMobility = sender->GetNode ()->GetObject<MobilityModel> ();
+  NS_ASSERT (senderMobility != 0);
+
+  double cutoff = GetCutoffDistance ();
+  Cell center = GetCell (senderMobility->GetPosition ());
+
+  // cell is larger than the cutoff distance plus movement since the last update,
+  // so all potential receivers are in the neighboring cells
+  for (int64_t x = center.first - 1; x <= center.first + 1; x++)
+    {
+      for (int64_t y = center.second - 1; y <= center.second + 1; y++)
+        {
+          Grid::const_iterator cell = m_grid.find (Cell (x, y));
+          if (cell == m_grid.end ())
+            continue;
+
+          for (std::vector<uint32_t>::const_iterator i = cell->second.begin (); i != cell->second.end (); i++)
+            {
+              Ptr<V2vBroadcastNetDevice> receiver = m_devices[*i];
+              if (receiver == sender)
+                continue;
+
+              double distance = senderMobility->GetDistanceFrom (m_mobility[*i]);
+              if (distance > cutoff)
+                continue;
+
+              bool decodable = m_random.GetValue () < GetReceptionProbability (distance);
+              Time delay = GetDelay (distance);
+
+#ifdef HAVE_NS3_MPI
+              if (receiver->GetNode ()->GetSystemId () != MpiInterface::GetSystemId ())
+                {
+                  TransmitRemote (receiver, packet, protocol, sender->GetAddress (), duration, decodable, delay);
+                  continue;
+                }
+#endif
+
+              Simulator::ScheduleWithContext (receiver->GetNode ()->GetId (), delay,
+                                              &V2vBroadcastNetDevice::StartReceive, receiver,
+                                              packet, protocol, sender->GetAddress (), duration, decodable);
+            }
+        }
+    }
+}
+
+#ifdef HAVE_NS3_MPI
+void
+V2vBroadcastChannel::TransmitRemote (Ptr<V2vBroadcastNetDevice> receiver, Ptr<const Packet> packet, uint16_t protocol,
+                                     const Address &from, const Time &duration, bool decodable, const Time &delay)
+{
+  NS_LOG_FUNCTION (this << receiver->GetNode ()->GetId () << packet);
+
+  Ptr<Packet> frame = packet->Copy ();
+
+  V2vRemoteFrameHeader header;
+  header.SetProtocol (protocol);
+  header.SetFrom (Mac48Address::ConvertFrom (from));
+  header.SetDuration (duration);
+  header.SetDecodable (decodable);
+  header.TakePacketTags (frame);
+  frame->AddHeader (header);
+
+  MpiInterface::SendPacket (frame, Simulator::Now () + delay, receiver->GetNode ()->GetId (), receiver->GetIfIndex ());
+}
+#endif
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_BROADCAST_CHANNEL_H
+#define V2V_BROADCAST_CHANNEL_H
+
+#include "ns3/channel.h"
+#include "ns3/nstime.h"
+#include "ns3/random-variable.h"
+#include "ns3/vector.h"
+
+#include <vector>
+#include <map>
+
+namespace ns3 {
+
+class Packet;
+class MobilityModel;
+
+namespace ndn {
+
+class V2vBroadcastNetDevice;
+
+/**
+ * \ingroup Ndn
+ * \brief Lightweight broadcast channel with probabilistic disk-range reception
+ *
+ * Instead of calculating received power and SINR, the channel decides whether a frame
+ * is received using the reception probability curve:
+ *
+ *   p(d) = 1 / (1 + exp ((d - ReceptionRange) / ReceptionSlope))
+ *
+ * Frames are delivered (as energy that occupies the receiver and may collide) only to
+ * devices closer than ReceptionRange + 7 * ReceptionSlope (p < 0.1%).  To find these
+ * devices without checking every device on the channel, devices are indexed in a uniform
+ * 2-D grid with the cell size equal to the cutoff distance plus slack for the movement
+ * of nodes between grid updates.  This makes the cost of a transmission proportional
+ * to the number of neighbors rather than to the number of nodes.
+ *
+ * Collisions and carrier sense are modeled by V2vBroadcastNetDevice
+ *
+ * When simulation is distributed over MPI ranks, frames for receivers simulated by other ranks
+ * are sent to them using MpiInterface, together with the reception parameters and packet
+ * tags (see V2vRemoteFrameHeader).
+ */
+class V2vBroadcastChannel : public Channel
+{
+public:
+  static TypeId
+  GetTypeId ();
+
+  V2vBroadcastChannel ();
+  virtual ~V2vBroadcastChannel ();
+
+  /**
+   * \brief Attach device to the channel
+   */
+  void
+  Add (Ptr<V2vBroadcastNetDevice> device);
+
+  /**
+   * \brief Start transmission of the frame by \p sender
+   *
+   * Every device within the cutoff distance starts receiving the frame after the propagation delay
+   */
+  void
+  Transmit (Ptr<V2vBroadcastNetDevice> sender, Ptr<const Packet> packet, uint16_t protocol, const Time &duration);
+
+  /**
+   * \brief Get reception probability at distance \p distance
+   */
+  double
+  GetReceptionProbability (double distance) const;
+
+  /**
+   * \brief Get distance beyond which frames are not delivered at all
+   */
+  double
+  GetCutoffDistance () const;
+
+  /**
+   * \brief Get delay between the start of transmission and the start of reception at distance \p distance
+   */
+  Time
+  GetDelay (double distance) const;
+
+  // from Channel
+  virtual uint32_t
+  GetNDevices () const;
+
+  virtual Ptr<NetDevice>
+  GetDevice (uint32_t i) const;
+
+protected:
+  virtual void
+  DoDispose ();
+
+private:
+  typedef std::pair<int64_t, int64_t> Cell;
+  typedef std::map<Cell, std::vector<uint32_t> > Grid;
+
+  Cell
+  GetCell (const Vector &position) const;
+
+  void
+  UpdateGrid ();
+
+#ifdef HAVE_NS3_MPI
+  void
+  TransmitRemote (Ptr<V2vBroadcastNetDevice> receiver, Ptr<const Packet> packet, uint16_t protocol,
+                  const Address &from, const Time &duration, bool decodable, const Time &delay);
+#endif
+
+private:
+  std::vector< Ptr<V2vBroadcastNetDevice> > m_devices;
+  std::vector< Ptr<MobilityModel> > m_mobility;
+
+  double m_receptionRange;
+  double m_receptionSlope;
+  double m_gridSlack;
+  Time m_gridUpdateInterval;
+  Time m_receptionDelay;
+
+  Grid m_grid;
+  double m_cellSize;
+  Time m_nextGridUpdate;
+
+  UniformVariable m_random;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_BROADCAST_CHANNEL_H
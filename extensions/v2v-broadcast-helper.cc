@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-broadcast-helper.h"
+#include "v2v-broadcast-channel.h"
+#include "v2v-broadcast-net-device.h"
+
+#include "ns3/node.h"
+
+#ifdef HAVE_NS3_MPI
+#include "ns3/mpi-interface.h"
+#include "ns3/mpi-receiver.h"
+#endif
+
+namespace ns3 {
+namespace ndn {
+
+V2vBroadcastHelper::V2vBroadcastHelper ()
+{
+  m_channelFactory.SetTypeId (V2vBroadcastChannel::GetTypeId ());
+  m_deviceFactory.SetTypeId (V2vBroadcastNetDevice::GetTypeId ());
+}
+
+void
+V2vBroadcastHelper::SetChannelAttribute (const std::string &name, const AttributeValue &value)
+{
+  m_channelFactory.Set (name, value);
+}
+
+void
+V2vBroadcastHelper::SetDeviceAttribute (const std::string &name, const AttributeValue &value)
+{
+  m_deviceFactory.Set (name, value);
+}
+
+NetDeviceContainer
+V2vBroadcastHelper::Install (const NodeContainer &nodes) const
+{
+  Ptr<V2vBroadcastChannel> channel = m_channelFactory.Create<V2vBroadcastChannel> ();
+
+  NetDeviceContainer devices;
+  for (NodeContainer::Iterator node = nodes.Begin (); node != nodes.End (); node++)
+    {
+      Ptr<V2vBroadcastNetDevice> device = m_deviceFactory.Create<V2vBroadcastNetDevice> ();
+      (*node)->AddDevice (device);
+      device->SetChannel (channel);
+
+#ifdef HAVE_NS3_MPI
+      if (MpiInterface::IsEnabled ())
+        {
+          // frames from the nodes simulated by other ranks
+          Ptr<MpiReceiver> receiver = CreateObject<MpiReceiver> ();
+          receiver->SetReceiveCallback (MakeCallback (&V2vBroadcastNetDevice::ReceiveRemote, device));
+          device->AggregateObject (receiver);
+        }
+#endif
+
+      devices.Add (device);
+    }
+
+  return devices;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,60 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_BROADCAST_HELPER_H
+#define V2V_BROADCAST_HELPER_H
+
+#include "ns3/object-factory.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief Helper to install V2vBroadcastNetDevice on nodes, all attached to one V2vBroadcastChannel
+ */
+class V2vBroadcastHelper
+{
+public:
+  V2vBroadcastHelper ();
+
+  void
+  SetChannelAttribute (const std::string &name, const AttributeValue &value);
+
+  void
+  SetDeviceAttribute (const std::string &name, const AttributeValue &value);
+
+  /**
+   * \brief Create a new channel and install devices attached to it on all nodes
+   */
+  NetDeviceContainer
+  Install (const NodeContainer &nodes) const;
+
+private:
+  ObjectFactory m_channelFactory;
+  ObjectFactory m_deviceFactory;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_BROADCAST_HELPER_H
@@ -0,0 +1,411 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-broadcast-net-device.h"
+#include "v2v-broadcast-channel.h"
+#include "v2v-remote-frame-header.h"
+
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.V2vBroadcastNetDevice");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vBroadcastNetDevice);
+
+TypeId
+V2vBroadcastNetDevice::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::V2vBroadcastNetDevice")
+    .SetParent<NetDevice> ()
+    .AddConstructor<V2vBroadcastNetDevice> ()
+
+    .AddAttribute ("DataRate", "Data rate of the frame payload",
+                   DataRateValue (DataRate ("24Mbps")),
+                   MakeDataRateAccessor (&V2vBroadcastNetDevice::m_dataRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("Preamble", "Fixed per-frame airtime overhead (preamble and PHY header)",
+                   TimeValue (MicroSeconds (20)),
+                   MakeTimeAccessor (&V2vBroadcastNetDevice::m_preamble),
+                   MakeTimeChecker ())
+    .AddAttribute ("Slot", "Backoff slot time",
+                   TimeValue (MicroSeconds (9)),
+                   MakeTimeAccessor (&V2vBroadcastNetDevice::m_slot),
+                   MakeTimeChecker ())
+    .AddAttribute ("Difs", "Time the medium has to be idle before backoff starts",
+                   TimeValue (MicroSeconds (34)),
+                   MakeTimeAccessor (&V2vBroadcastNetDevice::m_difs),
+                   MakeTimeChecker ())
+    .AddAttribute ("ContentionWindow", "Backoff is uniformly selected from [0, ContentionWindow] slots",
+                   UintegerValue (15),
+                   MakeUintegerAccessor (&V2vBroadcastNetDevice::m_contentionWindow),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MaxQueueSize", "Maximum number of frames waiting for transmission",
+                   UintegerValue (400),
+                   MakeUintegerAccessor (&V2vBroadcastNetDevice::m_maxQueueSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Mtu", "Maximum size of the frame payload",
+                   UintegerValue (2296),
+                   MakeUintegerAccessor (&V2vBroadcastNetDevice::SetMtu, &V2vBroadcastNetDevice::GetMtu),
+                   MakeUintegerChecker<uint16_t> ())
+
+    .AddTraceSource ("MacTxDrop", "Frame has been dropped because transmission queue is full",
+                     MakeTraceSourceAccessor (&V2vBroadcastNetDevice::m_macTxDropTrace))
+    .AddTraceSource ("PhyTxBegin", "Frame transmission has started",
+                     MakeTraceSourceAccessor (&V2vBroadcastNetDevice::m_phyTxBeginTrace))
+    .AddTraceSource ("PhyRxDrop", "Frame has not been received (collision, half-duplex, or not decodable)",
+                     MakeTraceSourceAccessor (&V2vBroadcastNetDevice::m_phyRxDropTrace))
+    ;
+  return tid;
+}
+
+V2vBroadcastNetDevice::V2vBroadcastNetDevice ()
+  : m_ifIndex (0)
+  , m_address (Mac48Address::Allocate ())
+  , m_mtu (2296)
+  , m_rxCorrupted (false)
+  , m_rxProtocol (0)
+{
+}
+
+V2vBroadcastNetDevice::~V2vBroadcastNetDevice ()
+{
+}
+
+void
+V2vBroadcastNetDevice::DoDispose ()
+{
+  m_node = 0;
+  m_channel = 0;
+  m_queue.clear ();
+  m_rxPacket = 0;
+
+  NetDevice::DoDispose ();
+}
+
+void
+V2vBroadcastNetDevice::SetChannel (Ptr<V2vBroadcastChannel> channel)
+{
+  m_channel = channel;
+  m_channel->Add (this);
+}
+
+Time
+V2vBroadcastNetDevice::GetAirtime (Ptr<const Packet> packet) const
+{
+  return m_preamble + Seconds (packet->GetSize () * 8.0 / m_dataRate.GetBitRate ());
+}
+
+bool
+V2vBroadcastNetDevice::Send (Ptr<Packet> packet, const Address &dest, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << packet << protocolNumber);
+
+  if (m_queue.size () >= m_maxQueueSize)
+    {
+      m_macTxDropTrace (packet);
+      return false;
+    }
+
+  QueueItem item;
+  item.m_packet = packet;
+  item.m_protocol = protocolNumber;
+  m_queue.push_back (item);
+
+  if (!m_accessEvent.IsRunning () && Simulator::Now () >= m_txEnd)
+    {
+      StartAccess ();
+    }
+  return true;
+}
+
+bool
+V2vBroadcastNetDevice::SendFrom (Ptr<Packet> packet, const Address &source, const Address &dest, uint16_t protocolNumber)
+{
+  return false;
+}
+
+void
+V2vBroadcastNetDevice::StartAccess ()
+{
+  if (m_accessEvent.IsRunning ())
+    {
+      // Send and EndTransmit may both ask for access at exactly m_txEnd
+      return;
+    }
+
+  Time idle = std::max (Simulator::Now (), m_busyEnd);
+  Time backoff = Seconds (m_slot.ToDouble (Time::S) * m_backoff.GetInteger (0, m_contentionWindow));
+
+  m_accessEvent = Simulator::Schedule (idle - Simulator::Now () + m_difs + backoff,
+                                       &V2vBroadcastNetDevice::TryTransmit, this);
+}
+
+void
+V2vBroadcastNetDevice::TryTransmit ()
+{
+  if (m_busyEnd > Simulator::Now ())
+    {
+      // medium became busy during backoff
+      StartAccess ();
+      return;
+    }
+
+  if (m_queue.empty ())
+    {
+      return;
+    }
+
+  const QueueItem &item = m_queue.front ();
+
+  Time airtime = GetAirtime (item.m_packet);
+  m_txEnd = Simulator::Now () + airtime;
+
+  m_phyTxBeginTrace (item.m_packet);
+  m_channel->Transmit (this, item.m_packet, item.m_protocol, airtime);
+
+  m_queue.pop_front ();
+  Simulator::Schedule (airtime, &V2vBroadcastNetDevice::EndTransmit, this);
+}
+
+void
+V2vBroadcastNetDevice::EndTransmit ()
+{
+  if (!m_queue.empty ())
+    {
+      StartAccess ();
+    }
+}
+
+void
+V2vBroadcastNetDevice::StartReceive (Ptr<const Packet> packet, uint16_t protocol, Address from, Time duration, bool decodable)
+{
+  Time end = Simulator::Now () + duration;
+
+  if (Simulator::Now () < m_txEnd)
+    {
+      // half-duplex
+      m_busyEnd = std::max (m_busyEnd, end);
+      m_phyRxDropTrace (packet);
+      return;
+    }
+
+  if (Simulator::Now () < m_busyEnd)
+    {
+      // collision: both frames (if the other one is still being received) are lost
+      m_rxCorrupted = true;
+      m_busyEnd = std::max (m_busyEnd, end);
+      m_phyRxDropTrace (packet);
+      return;
+    }
+
+  m_busyEnd = std::max (m_busyEnd, end);
+  m_rxEnd = end;
+  m_rxCorrupted = !decodable;
+  m_rxPacket = packet;
+  m_rxProtocol = protocol;
+  m_rxFrom = from;
+
+  Simulator::Schedule (duration, &V2vBroadcastNetDevice::EndReceive, this);
+}
+
+void
+V2vBroadcastNetDevice::ReceiveRemote (Ptr<Packet> frame)
+{
+  V2vRemoteFrameHeader header;
+  frame->RemoveHeader (header);
+  header.RestorePacketTags (frame);
+
+  StartReceive (frame, header.GetProtocol (), header.GetFrom (), header.GetDuration (), header.IsDecodable ());
+}
+
+void
+V2vBroadcastNetDevice::EndReceive ()
+{
+  if (m_rxPacket == 0 || Simulator::Now () < m_rxEnd)
+    {
+      // a frame that starts exactly when the previous one ends (StartReceive uses a
+      // strict Now < m_busyEnd) has replaced m_rxPacket, and is ended by its own event
+      return;
+    }
+
+  Ptr<const Packet> packet = m_rxPacket;
+  m_rxPacket = 0;
+
+  if (m_rxCorrupted)
+    {
+      m_phyRxDropTrace (packet);
+      return;
+    }
+
+  // every receiver gets its own copy, as with real devices
+  Ptr<Packet> copy = packet->Copy ();
+
+  if (!m_promiscRxCallback.IsNull ())
+    {
+      m_promiscRxCallback (this, copy, m_rxProtocol, m_rxFrom, GetBroadcast (), NetDevice::PACKET_BROADCAST);
+    }
+  if (!m_rxCallback.IsNull ())
+    {
+      m_rxCallback (this, copy, m_rxProtocol, m_rxFrom);
+    }
+}
+
+void
+V2vBroadcastNetDevice::SetIfIndex (const uint32_t index)
+{
+  m_ifIndex = index;
+}
+
+uint32_t
+V2vBroadcastNetDevice::GetIfIndex () const
+{
+  return m_ifIndex;
+}
+
+Ptr<Channel>
+V2vBroadcastNetDevice::GetChannel () const
+{
+  return m_channel;
+}
+
+void
+V2vBroadcastNetDevice::SetAddress (Address address)
+{
+  m_address = Mac48Address::ConvertFrom (address);
+}
+
+Address
+V2vBroadcastNetDevice::GetAddress () const
+{
+  return m_address;
+}
+
+bool
+V2vBroadcastNetDevice::SetMtu (const uint16_t mtu)
+{
+  m_mtu = mtu;
+  return true;
+}
+
+uint16_t
+V2vBroadcastNetDevice::GetMtu () const
+{
+  return m_mtu;
+}
+
+bool
+V2vBroadcastNetDevice::IsLinkUp () const
+{
+  return true;
+}
+
+void
+V2vBroadcastNetDevice::AddLinkChangeCallback (Callback<void> callback)
+{
+}
+
+bool
+V2vBroadcastNetDevice::IsBroadcast () const
+{
+  return true;
+}
+
+Address
+V2vBroadcastNetDevice::GetBroadcast () const
+{
+  return Mac48Address::GetBroadcast ();
+}
+
+bool
+V2vBroadcastNetDevice::IsMulticast () const
+{
+  return false;
+}
+
+Address
+V2vBroadcastNetDevice::GetMulticast (Ipv4Address multicastGroup) const
+{
+  return Mac48Address::GetBroadcast ();
+}
+
+Address
+V2vBroadcastNetDevice::GetMulticast (Ipv6Address addr) const
+{
+  return Mac48Address::GetBroadcast ();
+}
+
+bool
+V2vBroadcastNetDevice::IsBridge () const
+{
+  return false;
+}
+
+bool
+V2vBroadcastNetDevice::IsPointToPoint () const
+{
+  return false;
+}
+
+Ptr<Node>
+V2vBroadcastNetDevice::GetNode () const
+{
+  return m_node;
+}
+
+void
+V2vBroadcastNetDevice::SetNode (Ptr<Node> node)
+{
+  m_node = node;
+}
+
+bool
+V2vBroadcastNetDevice::NeedsArp () const
+{
+  return false;
+}
+
+void
+V2vBroadcastNetDevice::SetReceiveCallback (NetDevice::ReceiveCallback cb)
+{
+  m_rxCallback = cb;
+}
+
+void
+V2vBroadcastNetDevice::SetPromiscReceiveCallback (NetDevice::PromiscReceiveCallback cb)
+{
+  m_promiscRxCallback = cb;
+}
+
+bool
+V2vBroadcastNetDevice::SupportsSendFrom () const
+{
+  return false;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_BROADCAST_NET_DEVICE_H
+#define V2V_BROADCAST_NET_DEVICE_H
+
+#include "ns3/net-device.h"
+#include "ns3/mac48-address.h"
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/random-variable.h"
+#include "ns3/traced-callback.h"
+
+#include <deque>
+
+namespace ns3 {
+
+class Node;
+
+namespace ndn {
+
+class V2vBroadcastChannel;
+
+/**
+ * \ingroup Ndn
+ * \brief Lightweight broadcast NetDevice for fast large-scale parameter screening
+ *
+ * Replaces 802.11 PHY/MAC with a simple model:
+ * - frame airtime is the preamble plus the payload at the fixed data rate;
+ * - before transmitting, device waits until the medium is idle, then for DIFS and a random
+ *   backoff (backoff is redrawn if the medium becomes busy in the meantime);
+ * - device is half-duplex and receives one frame at a time: a frame that arrives while
+ *   another one is being received corrupts it and is lost itself (no capture);
+ * - whether a frame is decodable is decided by the channel (see V2vBroadcastChannel).
+ *
+ * All frames are broadcast.  The device is meant to be used with V2vNetDeviceFace,
+ * which does not need to know anything about it.
+ */
+class V2vBroadcastNetDevice : public NetDevice
+{
+public:
+  static TypeId
+  GetTypeId ();
+
+  V2vBroadcastNetDevice ();
+  virtual ~V2vBroadcastNetDevice ();
+
+  void
+  SetChannel (Ptr<V2vBroadcastChannel> channel);
+
+  /**
+   * \brief Called by the channel when the first bit of the frame arrives to the device
+   *
+   * \param decodable whether frame can be decoded if it does not collide with other frames
+   */
+  void
+  StartReceive (Ptr<const Packet> packet, uint16_t protocol, Address from, Time duration, bool decodable);
+
+  /**
+   * \brief Called (through MpiReceiver) when the frame is transmitted by the node simulated by another MPI rank
+   *
+   * \see V2vRemoteFrameHeader
+   */
+  void
+  ReceiveRemote (Ptr<Packet> frame);
+
+  // from NetDevice
+  virtual void
+  SetIfIndex (const uint32_t index);
+
+  virtual uint32_t
+  GetIfIndex () const;
+
+  virtual Ptr<Channel>
+  GetChannel () const;
+
+  virtual void
+  SetAddress (Address address);
+
+  virtual Address
+  GetAddress () const;
+
+  virtual bool
+  SetMtu (const uint16_t mtu);
+
+  virtual uint16_t
+  GetMtu () const;
+
+  virtual bool
+  IsLinkUp () const;
+
+  virtual void
+  AddLinkChangeCallback (Callback<void> callback);
+
+  virtual bool
+  IsBroadcast () const;
+
+  virtual Address
+  GetBroadcast () const;
+
+  virtual bool
+  IsMulticast () const;
+
+  virtual Address
+  GetMulticast (Ipv4Address multicastGroup) const;
+
+  virtual Address
+  GetMulticast (Ipv6Address addr) const;
+
+  virtual bool
+  IsBridge () const;
+
+  virtual bool
+  IsPointToPoint () const;
+
+  virtual bool
+  Send (Ptr<Packet> packet, const Address &dest, uint16_t protocolNumber);
+
+  virtual bool
+  SendFrom (Ptr<Packet> packet, const Address &source, const Address &dest, uint16_t protocolNumber);
+
+  virtual Ptr<Node>
+  GetNode () const;
+
+  virtual void
+  SetNode (Ptr<Node> node);
+
+  virtual bool
+  NeedsArp () const;
+
+  virtual void
+  SetReceiveCallback (NetDevice::ReceiveCallback cb);
+
+  virtual void
+  SetPromiscReceiveCallback (NetDevice::PromiscReceiveCallback cb);
+
+  virtual bool
+  SupportsSendFrom () const;
+
+protected:
+  virtual void
+  DoDispose ();
+
+private:
+  /// \brief Schedule transmission attempt after the medium becomes idle, DIFS, and backoff
+  void
+  StartAccess ();
+
+  void
+  TryTransmit ();
+
+  void
+  EndTransmit ();
+
+  void
+  EndReceive ();
+
+  Time
+  GetAirtime (Ptr<const Packet> packet) const;
+
+private:
+  Ptr<Node> m_node;
+  Ptr<V2vBroadcastChannel> m_channel;
+  uint32_t m_ifIndex;
+  Mac48Address m_address;
+  uint16_t m_mtu;
+
+  NetDevice::ReceiveCallback m_rxCallback;
+  NetDevice::PromiscReceiveCallback m_promiscRxCallback;
+
+  // transmission
+  struct QueueItem
+  {
+    Ptr<Packet> m_packet;
+    uint16_t m_protocol;
+  };
+  std::deque<QueueItem> m_queue;
+  uint32_t m_maxQueueSize;
+
+  DataRate m_dataRate;
+  Time m_preamble;
+  Time m_slot;
+  Time m_difs;
+  uint32_t m_contentionWindow;
+  UniformVariable m_backoff;
+
+  EventId m_accessEvent;
+  Time m_txEnd;
+
+  // reception
+  Time m_busyEnd;     ///< \brief until when the medium is sensed busy
+  Time m_rxEnd;       ///< \brief end of the frame being received
+  bool m_rxCorrupted;
+  Ptr<const Packet> m_rxPacket;
+  uint16_t m_rxProtocol;
+  Address m_rxFrom;
+
+  TracedCallback<Ptr<const Packet> > m_macTxDropTrace;
+  TracedCallback<Ptr<const Packet> > m_phyTxBeginTrace;
+  TracedCallback<Ptr<const Packet> > m_phyRxDropTrace;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_BROADCAST_NET_DEVICE_H
@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-cutoff-propagation-loss-model.h"
+#include "v2v-tabulated-propagation-loss-model.h"
+
+#include "ns3/mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+
+#include <cmath>
+#include <algorithm>
+#include <boost/math/special_functions/gamma.hpp>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.V2vCutoffPropagationLossModel");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vCutoffPropagationLossModel);
+
+TypeId
+V2vCutoffPropagationLossModel::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::V2vCutoffPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .AddConstructor<V2vCutoffPropagationLossModel> ()
+
+    .AddAttribute ("CutoffRxPower", "Received power (dBm) below which signal is ignored. Should be well below noise floor, "
+                   "so ignored signals do not noticeably contribute to the interference",
+                   DoubleValue (-110.0),
+                   MakeDoubleAccessor (&V2vCutoffPropagationLossModel::m_cutoffRxPower),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("OutageProbability", "Probability that fading gain exceeds the fading margin used to calculate the cutoff distance",
+                   DoubleValue (1e-6),
+                   MakeDoubleAccessor (&V2vCutoffPropagationLossModel::m_outageProbability),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("Tabulated", "Evaluate the chain within the cutoff distance using V2vTabulatedPropagationLossModel",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&V2vCutoffPropagationLossModel::m_tabulated),
+                   MakeBooleanChecker ())
+    ;
+  return tid;
+}
+
+V2vCutoffPropagationLossModel::V2vCutoffPropagationLossModel ()
+  : m_tabulated (false)
+  , m_referenceLoss (0)
+  , m_fadingMargin (0)
+  , m_cachedTxPower (0)
+  , m_cachedCutoff (-1)
+{
+}
+
+double
+V2vCutoffPropagationLossModel::GetDoubleAttribute (Ptr<Object> object, const std::string &name) const
+{
+  DoubleValue value;
+  object->GetAttribute (name, value);
+  return value.Get ();
+}
+
+void
+V2vCutoffPropagationLossModel::Initialize () const
+{
+  if (m_threeLogDistance != 0)
+    return;
+
+  m_threeLogDistance = CreateObject<ThreeLogDistancePropagationLossModel> ();
+  m_nakagami = CreateObject<NakagamiPropagationLossModel> ();
+  m_threeLogDistance->SetNext (m_nakagami);
+
+  if (m_tabulated)
+    m_evaluator = CreateObject<V2vTabulatedPropagationLossModel> ();
+  else
+    m_evaluator = m_threeLogDistance;
+
+  m_distance[0] = GetDoubleAttribute (m_threeLogDistance, "Distance0");
+  m_distance[1] = GetDoubleAttribute (m_threeLogDistance, "Distance1");
+  m_distance[2] = GetDoubleAttribute (m_threeLogDistance, "Distance2");
+  m_exponent[0] = GetDoubleAttribute (m_threeLogDistance, "Exponent0");
+  m_exponent[1] = GetDoubleAttribute (m_threeLogDistance, "Exponent1");
+  m_exponent[2] = GetDoubleAttribute (m_threeLogDistance, "Exponent2");
+  m_referenceLoss = GetDoubleAttribute (m_threeLogDistance, "ReferenceLoss");
+
+  // Nakagami power gain is Gamma(m, 1/m) distributed, the heaviest tail is for the smallest m
+  double m = std::min (GetDoubleAttribute (m_nakagami, "m0"),
+                       std::min (GetDoubleAttribute (m_nakagami, "m1"),
+                                 GetDoubleAttribute (m_nakagami, "m2")));
+  double gain = boost::math::gamma_q_inv (m, m_outageProbability) / m;
+  m_fadingMargin = 10 * std::log10 (gain);
+
+  NS_LOG_DEBUG ("Fading margin " << m_fadingMargin << " dB (m = " << m << ")");
+}
+
+double
+V2vCutoffPropagationLossModel::GetCutoffDistance (double txPowerDbm) const
+{
+  Initialize ();
+
+  if (m_cachedCutoff >= 0 && m_cachedTxPower == txPowerDbm)
+    return m_cachedCutoff;
+
+  // loss that guarantees rx power below the cutoff even with the fading margin
+  double loss = txPowerDbm + m_fadingMargin - m_cutoffRxPower;
+
+  // invert the piecewise log-distance function (see ThreeLogDistancePropagationLossModel)
+  double distance = m_distance[0];
+  double segmentLoss = m_referenceLoss;
+  for (uint32_t i = 0; i < 3 && loss > segmentLoss; i++)
+    {
+      double end = (i < 2) ? m_distance[i + 1] : 0;
+      double endLoss = (i < 2) ? segmentLoss + 10 * m_exponent[i] * std::log10 (end / m_distance[i]) : 0;
+
+      if (i == 2 || loss <= endLoss)
+        {
+          distance = m_distance[i] * std::pow (10, (loss - segmentLoss) / (10 * m_exponent[i]));
+          break;
+        }
+
+      distance = end;
+      segmentLoss = endLoss;
+    }
+
+  m_cachedTxPower = txPowerDbm;
+  m_cachedCutoff = distance;
+
+  NS_LOG_DEBUG ("Cutoff distance for " << txPowerDbm << " dBm is " << distance << " m");
+  return distance;
+}
+
+double
+V2vCutoffPropagationLossModel::DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  if (a->GetDistanceFrom (b) > GetCutoffDistance (txPowerDbm))
+    {
+      return -1000.0;
+    }
+
+  return m_evaluator->CalcRxPower (txPowerDbm, a, b);
+}
+
+int64_t
+V2vCutoffPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  Initialize ();
+  return m_evaluator->AssignStreams (stream);
+}
+
+} // namespace ndn
+} // namespace ns3
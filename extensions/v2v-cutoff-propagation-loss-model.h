@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_CUTOFF_PROPAGATION_LOSS_MODEL_H
+#define V2V_CUTOFF_PROPAGATION_LOSS_MODEL_H
+
+#include "ns3/propagation-loss-model.h"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief ThreeLogDistance + Nakagami propagation loss with the reception cutoff distance
+ *
+ * Model owns the ThreeLogDistancePropagationLossModel -> NakagamiPropagationLossModel chain
+ * (configured using their own attribute defaults) and evaluates it only for receivers closer
+ * than the cutoff distance.  Farther receivers get -1000 dBm without any calculations and
+ * without drawing random fading samples.
+ *
+ * The cutoff is derived from the model settings: it is the distance at which the mean
+ * received power (ThreeLogDistance) plus the fading margin falls below CutoffRxPower.
+ * The fading margin is such that Nakagami fading gain (with the smallest m of the model)
+ * exceeds it with probability of at most OutageProbability.
+ *
+ * With Tabulated attribute set, the chain is evaluated using V2vTabulatedPropagationLossModel.
+ *
+ * The model saves only the loss calculation and the fading draws for far receivers.  It does
+ * not reduce the number of receivers a transmission visits: YansWifiChannel still loops over
+ * all devices and schedules a reception event for each of them, which the PHY then drops.
+ * For culling of far receivers use the lightweight V2vBroadcastChannel instead.
+ */
+class V2vCutoffPropagationLossModel : public PropagationLossModel
+{
+public:
+  static TypeId
+  GetTypeId ();
+
+  V2vCutoffPropagationLossModel ();
+
+  /**
+   * \brief Get distance beyond which signal transmitted with \p txPowerDbm is considered not received
+   */
+  double
+  GetCutoffDistance (double txPowerDbm) const;
+
+private:
+  // from PropagationLossModel
+  virtual double
+  DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
+  virtual int64_t
+  DoAssignStreams (int64_t stream);
+
+  /// \brief Create inner models and read their parameters (done on the first use)
+  void
+  Initialize () const;
+
+  double
+  GetDoubleAttribute (Ptr<Object> object, const std::string &name) const;
+
+private:
+  double m_cutoffRxPower;
+  double m_outageProbability;
+  bool m_tabulated;
+
+  mutable Ptr<PropagationLossModel> m_threeLogDistance;
+  mutable Ptr<PropagationLossModel> m_nakagami;
+  mutable Ptr<PropagationLossModel> m_evaluator; ///< \brief either the original chain or the tabulated model
+
+  // parameters of ThreeLogDistance model
+  mutable double m_distance[3];
+  mutable double m_exponent[3];
+  mutable double m_referenceLoss;
+  mutable double m_fadingMargin;
+
+  // cutoff is recalculated only if tx power changes
+  mutable double m_cachedTxPower;
+  mutable double m_cachedCutoff;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_CUTOFF_PROPAGATION_LOSS_MODEL_H
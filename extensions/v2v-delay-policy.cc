@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-delay-policy.h"
+
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vDelayPolicy);
+NS_OBJECT_ENSURE_REGISTERED (V2vLinearDelayPolicy);
+NS_OBJECT_ENSURE_REGISTERED (V2vExponentialDelayPolicy);
+NS_OBJECT_ENSURE_REGISTERED (V2vSlottedDelayPolicy);
+
+TypeId
+V2vDelayPolicy::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::V2vDelayPolicy")
+    .SetParent<Object> ()
+    ;
+  return tid;
+}
+
+V2vDelayPolicy::~V2vDelayPolicy ()
+{
+}
+
+Time
+V2vDelayPolicy::AddJitter (double delay, const Time &jitter)
+{
+  return Seconds (std::abs (m_jitter.GetValue (delay, delay + jitter.ToDouble (Time::S))));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TypeId
+V2vLinearDelayPolicy::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::V2vLinearDelayPolicy")
+    .SetParent<V2vDelayPolicy> ()
+    .AddConstructor<V2vLinearDelayPolicy> ()
+    ;
+  return tid;
+}
+
+Time
+V2vLinearDelayPolicy::GetDelay (double distance, double maxDistance, const Time &maxDelay, const Time &jitter)
+{
+  // Mean waiting time.  Reversely proportional to the distance from the original transmitter
+  // Closer guys will tend to wait longer than guys far away
+  double meanWaiting = maxDelay.ToDouble (Time::S) * (maxDistance - distance) / maxDistance;
+
+  return AddJitter (meanWaiting, jitter);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TypeId
+V2vExponentialDelayPolicy::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::V2vExponentialDelayPolicy")
+    .SetParent<V2vDelayPolicy> ()
+    .AddConstructor<V2vExponentialDelayPolicy> ()
+
+    .AddAttribute ("Alpha", "Steepness of the delay function (the larger, the more far nodes are spread apart in time)",
+                   DoubleValue (3.0),
+                   MakeDoubleAccessor (&V2vExponentialDelayPolicy::m_alpha),
+                   MakeDoubleChecker<double> (0.001))
+    ;
+  return tid;
+}
+
+Time
+V2vExponentialDelayPolicy::GetDelay (double distance, double maxDistance, const Time &maxDelay, const Time &jitter)
+{
+  double closeness = (maxDistance - distance) / maxDistance;
+
+  // 0 for the farthest node, maxDelay for the closest one, steepest at the far end
+  double meanWaiting = maxDelay.ToDouble (Time::S) *
+    (1 - std::exp (-m_alpha * closeness)) / (1 - std::exp (-m_alpha));
+
+  return AddJitter (meanWaiting, jitter);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TypeId
+V2vSlottedDelayPolicy::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::V2vSlottedDelayPolicy")
+    .SetParent<V2vDelayPolicy> ()
+    .AddConstructor<V2vSlottedDelayPolicy> ()
+
+    .AddAttribute ("Slots", "Number of contention slots the distance range is split into",
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&V2vSlottedDelayPolicy::m_slots),
+                   MakeUintegerChecker<uint32_t> (1))
+    ;
+  return tid;
+}
+
+Time
+V2vSlottedDelayPolicy::GetDelay (double distance, double maxDistance, const Time &maxDelay, const Time &jitter)
+{
+  double closeness = (maxDistance - distance) / maxDistance;
+
+  uint32_t slot = std::min (static_cast<uint32_t> (closeness * m_slots), m_slots - 1);
+  double meanWaiting = maxDelay.ToDouble (Time::S) * slot / m_slots;
+
+  return AddJitter (meanWaiting, jitter);
+}
+
+} // namespace ndn
+} // namespace ns3
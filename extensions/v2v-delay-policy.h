@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_DELAY_POLICY_H
+#define V2V_DELAY_POLICY_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/random-variable.h"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief Policy that defines how long the low-priority (gradient-pushed) packet waits before transmission
+ *
+ * Waiting time consists of the distance-dependent part (the farther the node is from the
+ * previous transmitter, the shorter it waits) and the random jitter that is aimed to avoid
+ * collisions between nodes at similar distances.
+ *
+ * Policy is selected by V2vNetDeviceFace::DelayPolicy attribute
+ */
+class V2vDelayPolicy : public Object
+{
+public:
+  static TypeId
+  GetTypeId ();
+
+  virtual ~V2vDelayPolicy ();
+
+  /**
+   * \brief Get waiting time for the low-priority packet
+   *
+   * \param distance    distance from the previous transmitter (not larger than maxDistance)
+   * \param maxDistance gradient normalization distance
+   * \param maxDelay    waiting time of the closest node (MaxDelayLowPriority)
+   * \param jitter      size of the random jitter window
+   */
+  virtual Time
+  GetDelay (double distance, double maxDistance, const Time &maxDelay, const Time &jitter) = 0;
+
+protected:
+  /**
+   * \brief Add uniform jitter to the distance-dependent part of the delay
+   */
+  Time
+  AddJitter (double delay, const Time &jitter);
+
+private:
+  UniformVariable m_jitter;
+};
+
+/**
+ * \ingroup Ndn
+ * \brief Waiting time decreases linearly with the distance (the original gradient pushing)
+ */
+class V2vLinearDelayPolicy : public V2vDelayPolicy
+{
+public:
+  static TypeId
+  GetTypeId ();
+
+  virtual Time
+  GetDelay (double distance, double maxDistance, const Time &maxDelay, const Time &jitter);
+};
+
+/**
+ * \ingroup Ndn
+ * \brief Waiting time decreases exponentially with the distance
+ *
+ * Nodes far from the previous transmitter (the best candidates to forward) are spread
+ * wider apart in time than with the linear function, which reduces collisions between them
+ */
+class V2vExponentialDelayPolicy : public V2vDelayPolicy
+{
+public:
+  static TypeId
+  GetTypeId ();
+
+  virtual Time
+  GetDelay (double distance, double maxDistance, const Time &maxDelay, const Time &jitter);
+
+private:
+  double m_alpha;
+};
+
+/**
+ * \ingroup Ndn
+ * \brief Distance range is split into equal contention slots, all nodes in the same slot wait the same time (plus jitter)
+ */
+class V2vSlottedDelayPolicy : public V2vDelayPolicy
+{
+public:
+  static TypeId
+  GetTypeId ();
+
+  virtual Time
+  GetDelay (double distance, double maxDistance, const Time &maxDelay, const Time &jitter);
+
+private:
+  uint32_t m_slots;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_DELAY_POLICY_H
@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-duplicate-filter.h"
+
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.V2vDuplicateFilter");
+
+namespace ns3 {
+namespace ndn {
+
+// finalizer of splitmix64, spreads bits of the key over the whole word
+static uint64_t
+Mix (uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+V2vDuplicateFilter::V2vDuplicateFilter ()
+  : m_lifetime (Seconds (0))
+  , m_hashes (4)
+  , m_bits (0)
+  , m_nextRotation (Seconds (0))
+{
+  SetSize (16384);
+}
+
+void
+V2vDuplicateFilter::SetLifetime (const Time &lifetime)
+{
+  m_lifetime = lifetime;
+  Clear ();
+}
+
+const Time &
+V2vDuplicateFilter::GetLifetime () const
+{
+  return m_lifetime;
+}
+
+void
+V2vDuplicateFilter::SetSize (uint32_t bits)
+{
+  uint32_t words = std::max<uint32_t> ((bits + 63) / 64, 1);
+  m_current.assign (words, 0);
+  m_previous.assign (words, 0);
+  m_bits = words * 64;
+}
+
+uint32_t
+V2vDuplicateFilter::GetSize () const
+{
+  return m_bits;
+}
+
+void
+V2vDuplicateFilter::SetHashCount (uint32_t hashes)
+{
+  m_hashes = std::max<uint32_t> (hashes, 1);
+  Clear ();
+}
+
+uint32_t
+V2vDuplicateFilter::GetHashCount () const
+{
+  return m_hashes;
+}
+
+bool
+V2vDuplicateFilter::IsEnabled () const
+{
+  return !m_lifetime.IsZero ();
+}
+
+void
+V2vDuplicateFilter::Clear ()
+{
+  std::fill (m_current.begin (), m_current.end (), 0);
+  std::fill (m_previous.begin (), m_previous.end (), 0);
+  m_nextRotation = Simulator::Now () + m_lifetime;
+}
+
+void
+V2vDuplicateFilter::Rotate ()
+{
+  Time now = Simulator::Now ();
+  if (now < m_nextRotation)
+    return;
+
+  if (now >= m_nextRotation + m_lifetime)
+    {
+      // nothing was inserted for more than a lifetime, both generations are stale
+      Clear ();
+      return;
+    }
+
+  NS_LOG_DEBUG ("Rotating generations");
+  m_current.swap (m_previous);
+  std::fill (m_current.begin (), m_current.end (), 0);
+  m_nextRotation += m_lifetime;
+}
+
+bool
+V2vDuplicateFilter::Test (const std::vector<uint64_t> &generation, uint64_t h1, uint64_t h2) const
+{
+  for (uint32_t i = 0; i < m_hashes; i++)
+    {
+      uint64_t bit = (h1 + i * h2) % m_bits;
+      if ((generation[bit / 64] & (1ULL << (bit % 64))) == 0)
+        return false;
+    }
+  return true;
+}
+
+bool
+V2vDuplicateFilter::TestAndInsert (uint64_t key)
+{
+  Rotate ();
+
+  // double hashing: k bit positions from two independent hashes of the key
+  uint64_t h1 = Mix (key);
+  uint64_t h2 = Mix (h1 ^ key) | 1;
+
+  bool seen = Test (m_current, h1, h2) || Test (m_previous, h1, h2);
+
+  for (uint32_t i = 0; i < m_hashes; i++)
+    {
+      uint64_t bit = (h1 + i * h2) % m_bits;
+      m_current[bit / 64] |= 1ULL << (bit % 64);
+    }
+
+  return seen;
+}
+
+} // namespace ndn
+} // namespace ns3
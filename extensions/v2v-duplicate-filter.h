@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_DUPLICATE_FILTER_H
+#define V2V_DUPLICATE_FILTER_H
+
+#include "ns3/nstime.h"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief Time-decaying filter of recently seen keys (rotating Bloom filter)
+ *
+ * Filter consists of two Bloom filters (generations) of the same size.  Keys are inserted
+ * into the current generation and looked up in both.  Every lifetime the current generation
+ * becomes the previous one and the oldest generation is cleared, so a key is remembered for
+ * at least lifetime and at most twice the lifetime since it was last seen.  Rotation is done lazily, on the first
+ * access after the lifetime elapses.
+ *
+ * Memory does not depend on the number of keys, but the probability of false positives
+ * (new key reported as seen) grows with the number of keys inserted during one lifetime:
+ * for n keys, m bits, and k hash functions it is about (1 - exp (-k n / m))^k
+ */
+class V2vDuplicateFilter
+{
+public:
+  V2vDuplicateFilter ();
+
+  /**
+   * \brief Set how long key is remembered (zero disables the filter)
+   */
+  void
+  SetLifetime (const Time &lifetime);
+
+  const Time &
+  GetLifetime () const;
+
+  /**
+   * \brief Set size of one generation in bits (rounded up to the multiple of 64) and clear the filter
+   */
+  void
+  SetSize (uint32_t bits);
+
+  uint32_t
+  GetSize () const;
+
+  /**
+   * \brief Set number of hash functions (bits set per key)
+   */
+  void
+  SetHashCount (uint32_t hashes);
+
+  uint32_t
+  GetHashCount () const;
+
+  /**
+   * \brief Check if filter is enabled (lifetime is not zero)
+   */
+  bool
+  IsEnabled () const;
+
+  /**
+   * \brief Insert the key and check if it has been (probably) seen within the lifetime
+   *
+   * \returns true if key has been seen before
+   */
+  bool
+  TestAndInsert (uint64_t key);
+
+  /**
+   * \brief Remove all keys
+   */
+  void
+  Clear ();
+
+private:
+  void
+  Rotate ();
+
+  bool
+  Test (const std::vector<uint64_t> &generation, uint64_t h1, uint64_t h2) const;
+
+private:
+  Time m_lifetime;
+  uint32_t m_hashes;
+
+  std::vector<uint64_t> m_current;
+  std::vector<uint64_t> m_previous;
+  uint64_t m_bits;
+
+  Time m_nextRotation;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_DUPLICATE_FILTER_H
@@ -0,0 +1,240 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-face-stats.h"
+#include "ndn-v2v-net-device-face.h"
+
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/ndn-l3-protocol.h"
+
+#include <fstream>
+#include <algorithm>
+#include <boost/lexical_cast.hpp>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.V2vFaceStats");
+
+using namespace boost;
+using namespace std;
+
+namespace ns3 {
+namespace ndn {
+
+static const char *QUEUE_NAMES[] = { "primary", "low-priority", "retx" };
+static const char *CANCEL_REASON_NAMES[] = { "primary", "low-priority", "retx", "ignored" };
+static const char *DROP_REASON_NAMES[] = { "primary-full", "low-priority-full", "out-of-scope", "wrong-direction" };
+
+// 1ms buckets up to 128ms (retransmission delay is 50ms by default)
+static const double DELAY_BUCKET_WIDTH = 1.0;
+static const uint32_t DELAY_BUCKETS = 128;
+
+// one bucket per packet up to the default MAC queue size
+static const double OCCUPANCY_BUCKET_WIDTH = 1.0;
+static const uint32_t OCCUPANCY_BUCKETS = 101;
+
+V2vHistogram::V2vHistogram (double bucketWidth, uint32_t buckets)
+  : m_bucketWidth (bucketWidth)
+  , m_buckets (buckets, 0)
+  , m_count (0)
+  , m_sum (0)
+{
+}
+
+void
+V2vHistogram::Add (double value)
+{
+  uint32_t bucket = m_buckets.size () - 1;
+  if (value < m_bucketWidth * bucket)
+    {
+      bucket = static_cast<uint32_t> (std::max (value, 0.0) / m_bucketWidth);
+    }
+
+  m_buckets[bucket] ++;
+  m_count ++;
+  m_sum += value;
+}
+
+void
+V2vHistogram::Merge (const V2vHistogram &other)
+{
+  NS_ASSERT (m_buckets.size () == other.m_buckets.size () && m_bucketWidth == other.m_bucketWidth);
+
+  for (uint32_t i = 0; i < m_buckets.size (); i++)
+    {
+      m_buckets[i] += other.m_buckets[i];
+    }
+  m_count += other.m_count;
+  m_sum += other.m_sum;
+}
+
+uint64_t
+V2vHistogram::GetCount () const
+{
+  return m_count;
+}
+
+double
+V2vHistogram::GetMean () const
+{
+  if (m_count == 0)
+    return 0;
+
+  return m_sum / m_count;
+}
+
+void
+V2vHistogram::Print (std::ostream &os, const std::string &prefix) const
+{
+  for (uint32_t i = 0; i < m_buckets.size (); i++)
+    {
+      if (m_buckets[i] == 0)
+        continue;
+
+      os << prefix << "\t" << (m_bucketWidth * i) << "\t" << m_buckets[i] << "\n";
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+V2vFaceStats::V2vFaceStats ()
+  : m_queueingDelay (QUEUE_COUNT, V2vHistogram (DELAY_BUCKET_WIDTH, DELAY_BUCKETS))
+  , m_occupancy (QUEUE_COUNT, V2vHistogram (OCCUPANCY_BUCKET_WIDTH, OCCUPANCY_BUCKETS))
+{
+  std::fill (m_cancellations, m_cancellations + CANCEL_REASON_COUNT, 0);
+  std::fill (m_drops, m_drops + DROP_REASON_COUNT, 0);
+}
+
+void
+V2vFaceStats::NotifyDequeued (Queue queue, const Time &delay)
+{
+  m_queueingDelay[queue].Add (delay.ToDouble (Time::MS));
+}
+
+void
+V2vFaceStats::NotifyEnqueued (Queue queue, uint32_t size)
+{
+  m_occupancy[queue].Add (size);
+}
+
+void
+V2vFaceStats::NotifyCancelled (CancelReason reason)
+{
+  m_cancellations[reason] ++;
+}
+
+void
+V2vFaceStats::NotifyDropped (DropReason reason)
+{
+  m_drops[reason] ++;
+}
+
+void
+V2vFaceStats::Merge (const V2vFaceStats &other)
+{
+  for (uint32_t i = 0; i < QUEUE_COUNT; i++)
+    {
+      m_queueingDelay[i].Merge (other.m_queueingDelay[i]);
+      m_occupancy[i].Merge (other.m_occupancy[i]);
+    }
+
+  for (uint32_t i = 0; i < CANCEL_REASON_COUNT; i++)
+    m_cancellations[i] += other.m_cancellations[i];
+
+  for (uint32_t i = 0; i < DROP_REASON_COUNT; i++)
+    m_drops[i] += other.m_drops[i];
+}
+
+void
+V2vFaceStats::PrintHeader (std::ostream &os)
+{
+  os << "Node" << "\t"
+     << "FaceId" << "\t"
+     << "Metric" << "\t"
+     << "Type" << "\t"
+     << "Bucket" << "\t"
+     << "Count" << "\n";
+}
+
+void
+V2vFaceStats::Print (std::ostream &os, const std::string &prefix) const
+{
+  for (uint32_t i = 0; i < QUEUE_COUNT; i++)
+    {
+      m_queueingDelay[i].Print (os, prefix + "\tQueueingDelay\t" + QUEUE_NAMES[i]);
+      m_occupancy[i].Print (os, prefix + "\tOccupancy\t" + QUEUE_NAMES[i]);
+    }
+
+  for (uint32_t i = 0; i < CANCEL_REASON_COUNT; i++)
+    {
+      if (m_cancellations[i] > 0)
+        os << prefix << "\tCancelled\t" << CANCEL_REASON_NAMES[i] << "\t0\t" << m_cancellations[i] << "\n";
+    }
+
+  for (uint32_t i = 0; i < DROP_REASON_COUNT; i++)
+    {
+      if (m_drops[i] > 0)
+        os << prefix << "\tDropped\t" << DROP_REASON_NAMES[i] << "\t0\t" << m_drops[i] << "\n";
+    }
+}
+
+void
+V2vFaceStats::PrintAll (std::ostream &os)
+{
+  PrintHeader (os);
+
+  V2vFaceStats total;
+  for (NodeList::Iterator node = NodeList::Begin ();
+       node != NodeList::End ();
+       node++)
+    {
+      Ptr<L3Protocol> ndn = (*node)->GetObject<L3Protocol> ();
+      if (ndn == 0)
+        continue;
+
+      for (uint32_t faceId = 0; faceId < ndn->GetNFaces (); faceId++)
+        {
+          Ptr<V2vNetDeviceFace> face = DynamicCast<V2vNetDeviceFace> (ndn->GetFace (faceId));
+          if (face == 0)
+            continue;
+
+          face->GetStats ().Print (os, lexical_cast<string> ((*node)->GetId ()) + "\t" + lexical_cast<string> (face->GetId ()));
+          total.Merge (face->GetStats ());
+        }
+    }
+
+  total.Print (os, "all\tall");
+}
+
+void
+V2vFaceStats::DumpAll (const std::string &file)
+{
+  std::ofstream os (file.c_str (), std::ios_base::out | std::ios_base::trunc);
+  if (!os.is_open ())
+    {
+      NS_LOG_ERROR ("Cannot open " << file << " for writing");
+      return;
+    }
+
+  PrintAll (os);
+}
+
+} // namespace ndn
+} // namespace ns3
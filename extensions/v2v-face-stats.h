@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_FACE_STATS_H
+#define V2V_FACE_STATS_H
+
+#include "ns3/nstime.h"
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <stdint.h>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief Histogram with fixed-width buckets (the last bucket collects all values above the range)
+ */
+class V2vHistogram
+{
+public:
+  V2vHistogram (double bucketWidth, uint32_t buckets);
+
+  void
+  Add (double value);
+
+  /**
+   * \brief Add counts of another histogram with the same bucket layout
+   */
+  void
+  Merge (const V2vHistogram &other);
+
+  uint64_t
+  GetCount () const;
+
+  double
+  GetMean () const;
+
+  /**
+   * \brief Print non-empty buckets, one line per bucket: "<prefix>\t<bucket lower bound>\t<count>"
+   */
+  void
+  Print (std::ostream &os, const std::string &prefix) const;
+
+private:
+  double m_bucketWidth;
+  std::vector<uint64_t> m_buckets;
+  uint64_t m_count;
+  double m_sum;
+};
+
+/**
+ * \ingroup Ndn
+ * \brief Counters and histograms collected by one V2vNetDeviceFace
+ *
+ * Everything is kept in fixed-size arrays, so updating statistics does not allocate memory
+ */
+class V2vFaceStats
+{
+public:
+  enum Queue
+    {
+      PRIMARY_QUEUE = 0,
+      LOW_PRIORITY_QUEUE,
+      RETX_QUEUE,
+
+      QUEUE_COUNT
+    };
+
+  enum CancelReason
+    {
+      CANCEL_PRIMARY = 0,   ///< overheard while scheduled for transmission
+      CANCEL_LOW_PRIORITY,  ///< overheard while scheduled for low-priority transmission
+      CANCEL_RETX,          ///< overheard while waiting for retransmission
+      CANCEL_IGNORED,       ///< overheard, but not cancelled by the suppression policy (e.g., transmitter is closer to the source)
+
+      CANCEL_REASON_COUNT
+    };
+
+  enum DropReason
+    {
+      DROP_PRIMARY_FULL = 0,  ///< primary queue is full
+      DROP_LOW_PRIORITY_FULL, ///< primary or low-priority queue is full
+      DROP_OUT_OF_SCOPE,      ///< node is outside of the packet's geographic scope (GeoScopeTag)
+      DROP_WRONG_DIRECTION,   ///< node is not farther than the previous hop along the packet's propagation heading (GeoSrcTag)
+
+      DROP_REASON_COUNT
+    };
+
+  V2vFaceStats ();
+
+  /**
+   * \brief Record time the item spent in the queue
+   */
+  void
+  NotifyDequeued (Queue queue, const Time &delay);
+
+  /**
+   * \brief Record queue size right after an item has been added
+   */
+  void
+  NotifyEnqueued (Queue queue, uint32_t size);
+
+  void
+  NotifyCancelled (CancelReason reason);
+
+  void
+  NotifyDropped (DropReason reason);
+
+  /**
+   * \brief Add all counters of another face
+   */
+  void
+  Merge (const V2vFaceStats &other);
+
+  /**
+   * \brief Print statistics, lines are prefixed with \p prefix (e.g., node and face id)
+   */
+  void
+  Print (std::ostream &os, const std::string &prefix) const;
+
+  /**
+   * \brief Print header line for the output of Print and PrintAll
+   */
+  static void
+  PrintHeader (std::ostream &os);
+
+  /**
+   * \brief Print statistics of all V2V faces on all nodes, followed by the statistics aggregated over all faces
+   */
+  static void
+  PrintAll (std::ostream &os);
+
+  /**
+   * \brief Write output of PrintAll to the file
+   */
+  static void
+  DumpAll (const std::string &file);
+
+private:
+  std::vector<V2vHistogram> m_queueingDelay; ///< \brief in milliseconds, per queue
+  std::vector<V2vHistogram> m_occupancy;     ///< \brief per queue
+  uint64_t m_cancellations[CANCEL_REASON_COUNT];
+  uint64_t m_drops[DROP_REASON_COUNT];
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_FACE_STATS_H
@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-highway-partition.h"
+#include "v2v-broadcast-channel.h"
+
+#include "ns3/node.h"
+#include "ns3/mobility-model.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+
+#ifdef HAVE_NS3_MPI
+#include "ns3/mpi-interface.h"
+#include "ns3/point-to-point-helper.h"
+#endif
+
+#include <limits>
+#include <boost/lexical_cast.hpp>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.V2vHighwayPartition");
+
+namespace ns3 {
+namespace ndn {
+
+static uint32_t
+GetNRanks ()
+{
+#ifdef HAVE_NS3_MPI
+  if (MpiInterface::IsEnabled ())
+    return MpiInterface::GetSize ();
+#endif
+  return 1;
+}
+
+static uint32_t
+GetThisRank ()
+{
+#ifdef HAVE_NS3_MPI
+  if (MpiInterface::IsEnabled ())
+    return MpiInterface::GetSystemId ();
+#endif
+  return 0;
+}
+
+uint32_t
+V2vHighwayPartition::GetRank (uint32_t car, uint32_t numberOfCars)
+{
+  return static_cast<uint64_t> (car) * GetNRanks () / numberOfCars;
+}
+
+NodeContainer
+V2vHighwayPartition::Create (uint32_t numberOfCars)
+{
+  NodeContainer nodes;
+  for (uint32_t car = 0; car < numberOfCars; car++)
+    {
+      nodes.Create (1, GetRank (car, numberOfCars));
+    }
+  return nodes;
+}
+
+bool
+V2vHighwayPartition::IsLocal (Ptr<Node> node)
+{
+  return node->GetSystemId () == GetThisRank ();
+}
+
+std::string
+V2vHighwayPartition::GetFileSuffix ()
+{
+  if (GetNRanks () == 1)
+    return "";
+
+  return ".rank-" + boost::lexical_cast<std::string> (GetThisRank ());
+}
+
+Time
+V2vHighwayPartition::InstallLookahead (const NodeContainer &nodes)
+{
+  if (GetNRanks () == 1)
+    return Seconds (0);
+
+#ifdef HAVE_NS3_MPI
+  Ptr<V2vBroadcastChannel> channel;
+  for (uint32_t i = 0; channel == 0 && i < nodes.Get (0)->GetNDevices (); i++)
+    {
+      channel = DynamicCast<V2vBroadcastChannel> (nodes.Get (0)->GetDevice (i)->GetChannel ());
+    }
+  NS_ABORT_MSG_IF (channel == 0, "Only V2vBroadcastChannel supports distributed simulation");
+
+  // closest cars of the different segments are at the segment boundaries
+  double minDistance = std::numeric_limits<double>::max ();
+  for (uint32_t i = 0; i + 1 < nodes.GetN (); i++)
+    {
+      if (nodes.Get (i)->GetSystemId () == nodes.Get (i + 1)->GetSystemId ())
+        continue;
+
+      double distance = nodes.Get (i)->GetObject<MobilityModel> ()->GetDistanceFrom (nodes.Get (i + 1)->GetObject<MobilityModel> ());
+      minDistance = std::min (minDistance, distance);
+    }
+
+  Time lookahead = channel->GetDelay (minDistance);
+  NS_ABORT_MSG_IF (lookahead.IsZero (), "Zero lookahead: cars of different segments are at the same position and ReceptionDelay is zero");
+
+  NS_LOG_INFO ("Lookahead " << lookahead.GetNanoSeconds () << "ns (minimum distance between segments " << minDistance << "m)");
+
+  PointToPointHelper p2p;
+  p2p.SetChannelAttribute ("Delay", TimeValue (lookahead));
+  for (uint32_t i = 0; i + 1 < nodes.GetN (); i++)
+    {
+      if (nodes.Get (i)->GetSystemId () != nodes.Get (i + 1)->GetSystemId ())
+        {
+          p2p.Install (nodes.Get (i), nodes.Get (i + 1));
+        }
+    }
+
+  return lookahead;
+#else
+  return Seconds (0);
+#endif
+}
+
+} // namespace ndn
+} // namespace ns3
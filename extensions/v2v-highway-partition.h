@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_HIGHWAY_PARTITION_H
+#define V2V_HIGHWAY_PARTITION_H
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief Helper to distribute highway simulation over MPI ranks
+ *
+ * Highway is split into contiguous segments, one per rank: cars are assigned to ranks in
+ * blocks in the order they are placed by HighwayPositionAllocator.  Cars in the highway
+ * scenarios move with the same velocity, so segments stay contiguous during the simulation.
+ *
+ * Only V2vBroadcastChannel supports exchanging frames between ranks.  Lookahead between
+ * ranks is the smallest V2vBroadcastChannel delay between cars of different segments.
+ *
+ * Without MPI support (or when MPI is not enabled), everything is simulated by one rank.
+ */
+class V2vHighwayPartition
+{
+public:
+  /**
+   * \brief Get rank that simulates car \p car out of \p numberOfCars
+   */
+  static uint32_t
+  GetRank (uint32_t car, uint32_t numberOfCars);
+
+  /**
+   * \brief Create nodes for \p numberOfCars cars, each assigned to its rank
+   */
+  static NodeContainer
+  Create (uint32_t numberOfCars);
+
+  /**
+   * \brief Check if node is simulated by this rank
+   */
+  static bool
+  IsLocal (Ptr<Node> node);
+
+  /**
+   * \brief Get suffix for output files of this rank ("" if simulation is not distributed)
+   */
+  static std::string
+  GetFileSuffix ();
+
+  /**
+   * \brief Declare lookahead between neighboring segments
+   *
+   * DistributedSimulatorImpl derives lookahead only from point-to-point links between
+   * nodes of different ranks, so every pair of cars at the segment boundary is connected
+   * with a point-to-point link that has delay equal to the lookahead.  Links do not carry
+   * any traffic.  Should be called after mobility model is installed (positions are needed
+   * to get the lookahead) and after NDN stack is installed (so no NDN faces are created on
+   * the links).
+   *
+   * \returns lookahead or zero if simulation is not distributed
+   */
+  static Time
+  InstallLookahead (const NodeContainer &nodes);
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_HIGHWAY_PARTITION_H
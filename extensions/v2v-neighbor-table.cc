@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-neighbor-table.h"
+
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.V2vNeighborTable");
+
+namespace ns3 {
+namespace ndn {
+
+V2vNeighborTable::V2vNeighborTable ()
+  : m_timeout (Seconds (1.0))
+  , m_nextRefresh (Seconds (0))
+  , m_neighborCount (0)
+  , m_maxDistance (0)
+{
+}
+
+void
+V2vNeighborTable::SetTimeout (const Time &timeout)
+{
+  m_timeout = timeout;
+  m_nextRefresh = Seconds (0);
+}
+
+const Time &
+V2vNeighborTable::GetTimeout () const
+{
+  return m_timeout;
+}
+
+void
+V2vNeighborTable::Update (const Address &neighbor, const Vector &position)
+{
+  Neighbor &entry = m_neighbors[neighbor];
+  entry.m_position = position;
+  entry.m_lastSeen = Simulator::Now ();
+}
+
+uint32_t
+V2vNeighborTable::GetNeighborCount (const Vector &position)
+{
+  Refresh (position);
+  return m_neighborCount;
+}
+
+double
+V2vNeighborTable::GetMaxDistance (const Vector &position)
+{
+  Refresh (position);
+  return m_maxDistance;
+}
+
+void
+V2vNeighborTable::Refresh (const Vector &position)
+{
+  Time now = Simulator::Now ();
+  if (now < m_nextRefresh)
+    return;
+
+  // statistics are good enough if they are not older than a tenth of the neighbor lifetime
+  m_nextRefresh = now + Seconds (m_timeout.ToDouble (Time::S) / 10);
+
+  m_neighborCount = 0;
+  m_maxDistance = 0;
+
+  NeighborMap::iterator neighbor = m_neighbors.begin ();
+  while (neighbor != m_neighbors.end ())
+    {
+      if (neighbor->second.m_lastSeen + m_timeout < now)
+        {
+          m_neighbors.erase (neighbor++);
+          continue;
+        }
+
+      m_neighborCount ++;
+      m_maxDistance = std::max (m_maxDistance, CalculateDistance (position, neighbor->second.m_position));
+      neighbor ++;
+    }
+
+  NS_LOG_DEBUG ("Neighbors: " << m_neighborCount << ", farthest at " << m_maxDistance);
+}
+
+} // namespace ndn
+} // namespace ns3
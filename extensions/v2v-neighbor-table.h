@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_NEIGHBOR_TABLE_H
+#define V2V_NEIGHBOR_TABLE_H
+
+#include "ns3/address.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+
+#include <map>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief Table of one-hop neighbors, learned from the overheard frames
+ *
+ * For each neighbor (link-layer address of the transmitter) the table keeps the last
+ * known position (from GeoTransmissionTag) and the time the neighbor was last heard.
+ * Neighbors that have not been heard for longer than the timeout are dropped.
+ *
+ * Density statistics (number of neighbors and distance to the farthest one) are
+ * recalculated lazily, at most once per refresh interval
+ */
+class V2vNeighborTable
+{
+public:
+  V2vNeighborTable ();
+
+  /**
+   * \brief Set how long neighbor stays in the table after it was last heard
+   */
+  void
+  SetTimeout (const Time &timeout);
+
+  const Time &
+  GetTimeout () const;
+
+  /**
+   * \brief Record that neighbor has been heard at the specified position
+   */
+  void
+  Update (const Address &neighbor, const Vector &position);
+
+  /**
+   * \brief Get number of the currently known neighbors
+   */
+  uint32_t
+  GetNeighborCount (const Vector &position);
+
+  /**
+   * \brief Get distance from \p position to the farthest currently known neighbor (0 if there are no neighbors)
+   */
+  double
+  GetMaxDistance (const Vector &position);
+
+private:
+  void
+  Refresh (const Vector &position);
+
+private:
+  struct Neighbor
+  {
+    Vector m_position;
+    Time m_lastSeen;
+  };
+  typedef std::map<Address, Neighbor> NeighborMap;
+
+  NeighborMap m_neighbors;
+  Time m_timeout;
+
+  // cached statistics
+  Time m_nextRefresh;
+  uint32_t m_neighborCount;
+  double m_maxDistance;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_NEIGHBOR_TABLE_H
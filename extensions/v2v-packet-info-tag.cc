@@ -0,0 +1,213 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-packet-info-tag.h"
+
+#include "ns3/log.h"
+
+#include <limits>
+#include <map>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.V2vPacketInfoTag");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vPacketInfoTag);
+
+typedef std::map<Name, uint32_t> NameIds;
+typedef std::vector< Ptr<const Name> > InternedNames;
+
+static NameIds &
+GetNameIds ()
+{
+  static NameIds nameIds;
+  return nameIds;
+}
+
+static InternedNames &
+GetInternedNames ()
+{
+  static InternedNames names;
+  return names;
+}
+
+TypeId
+V2vPacketInfoTag::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::V2vPacketInfoTag")
+    .SetParent<Tag> ()
+    .AddConstructor<V2vPacketInfoTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+V2vPacketInfoTag::GetInstanceTypeId () const
+{
+  return V2vPacketInfoTag::GetTypeId ();
+}
+
+V2vPacketInfoTag::V2vPacketInfoTag ()
+  : m_type (HeaderHelper::CONTENT_OBJECT_NDNSIM)
+  , m_nameId (std::numeric_limits<uint32_t>::max ())
+{
+}
+
+V2vPacketInfoTag::V2vPacketInfoTag (HeaderHelper::Type type, const Name &name)
+  : m_type (NormalizeType (type))
+  , m_nameId (InternName (name))
+{
+}
+
+HeaderHelper::Type
+V2vPacketInfoTag::GetType () const
+{
+  return static_cast<HeaderHelper::Type> (m_type);
+}
+
+bool
+V2vPacketInfoTag::IsInterest () const
+{
+  return m_type == HeaderHelper::INTEREST_NDNSIM;
+}
+
+uint32_t
+V2vPacketInfoTag::GetNameId () const
+{
+  return m_nameId;
+}
+
+Ptr<const Name>
+V2vPacketInfoTag::GetName () const
+{
+  return GetInternedName (m_nameId);
+}
+
+V2vPacketInfoTag
+V2vPacketInfoTag::Get (Ptr<const Packet> packet)
+{
+  V2vPacketInfoTag tag;
+  if (packet->PeekPacketTag (tag))
+    {
+      return tag;
+    }
+
+  NS_LOG_DEBUG ("Packet " << packet->GetUid () << " is not tagged yet, parsing NDN header");
+
+  HeaderHelper::Type type = HeaderHelper::GetNdnHeaderType (packet);
+  Ptr<const Name> name = HeaderHelper::GetName (packet);
+  NS_ASSERT (name != 0);
+
+  tag = V2vPacketInfoTag (type, *name);
+  packet->AddPacketTag (tag);
+
+  return tag;
+}
+
+void
+V2vPacketInfoTag::Attach (Ptr<const Packet> packet, HeaderHelper::Type type, const Name &name)
+{
+  V2vPacketInfoTag tag;
+  if (packet->PeekPacketTag (tag))
+    {
+      return;
+    }
+
+  packet->AddPacketTag (V2vPacketInfoTag (type, name));
+}
+
+uint32_t
+V2vPacketInfoTag::InternName (const Name &name)
+{
+  NameIds &nameIds = GetNameIds ();
+  NameIds::iterator id = nameIds.find (name);
+  if (id != nameIds.end ())
+    {
+      return id->second;
+    }
+
+  InternedNames &names = GetInternedNames ();
+  uint32_t nameId = names.size ();
+
+  names.push_back (Create<Name> (name));
+  nameIds.insert (std::make_pair (name, nameId));
+
+  return nameId;
+}
+
+Ptr<const Name>
+V2vPacketInfoTag::GetInternedName (uint32_t nameId)
+{
+  InternedNames &names = GetInternedNames ();
+  NS_ASSERT_MSG (nameId < names.size (), "Name id " << nameId << " is not known");
+
+  return names[nameId];
+}
+
+HeaderHelper::Type
+V2vPacketInfoTag::NormalizeType (HeaderHelper::Type type)
+{
+  if (type == HeaderHelper::INTEREST_CCNB ||
+      type == HeaderHelper::INTEREST_NDNSIM)
+    {
+      return HeaderHelper::INTEREST_NDNSIM;
+    }
+  else if (type == HeaderHelper::CONTENT_OBJECT_CCNB ||
+           type == HeaderHelper::CONTENT_OBJECT_NDNSIM)
+    {
+      return HeaderHelper::CONTENT_OBJECT_NDNSIM;
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Unknown NDN header type");
+      return type;
+    }
+}
+
+uint32_t
+V2vPacketInfoTag::GetSerializedSize () const
+{
+  return sizeof (uint8_t) + sizeof (uint32_t);
+}
+
+void
+V2vPacketInfoTag::Serialize (TagBuffer i) const
+{
+  i.WriteU8 (m_type);
+  i.WriteU32 (m_nameId);
+}
+
+void
+V2vPacketInfoTag::Deserialize (TagBuffer i)
+{
+  m_type = i.ReadU8 ();
+  m_nameId = i.ReadU32 ();
+}
+
+void
+V2vPacketInfoTag::Print (std::ostream &os) const
+{
+  os << (IsInterest () ? "Interest " : "Data ") << m_nameId;
+}
+
+} // namespace ndn
+} // namespace ns3
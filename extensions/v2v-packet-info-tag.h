@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_PACKET_INFO_TAG_H
+#define V2V_PACKET_INFO_TAG_H
+
+#include "ns3/tag.h"
+#include "ns3/packet.h"
+#include "ns3/ndn-header-helper.h"
+#include "ns3/ndn-name-components.h"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief Tag caching the result of NDN header parsing (packet type and name)
+ *
+ * Name itself is not stored in the tag (packet tags are limited in size), instead
+ * names are interned in a global table and the tag carries only the name id.
+ *
+ * The tag is attached to a packet on the first parsing and travels with the packet
+ * and all its copies, so the header is parsed at most once per packet, not at every
+ * face, strategy, and tracer on every hop.
+ */
+class V2vPacketInfoTag : public Tag
+{
+public:
+  static TypeId
+  GetTypeId ();
+
+  virtual TypeId
+  GetInstanceTypeId () const;
+
+  /**
+   * \brief Default constructor (creates invalid tag)
+   */
+  V2vPacketInfoTag ();
+
+  /**
+   * \brief Create tag for the packet of \p type (will be normalized) with \p name
+   */
+  V2vPacketInfoTag (HeaderHelper::Type type, const Name &name);
+
+  /**
+   * \brief Get normalized packet type (either INTEREST_NDNSIM or CONTENT_OBJECT_NDNSIM)
+   */
+  HeaderHelper::Type
+  GetType () const;
+
+  /**
+   * \brief Check if packet is Interest
+   */
+  bool
+  IsInterest () const;
+
+  /**
+   * \brief Get id of the interned name
+   */
+  uint32_t
+  GetNameId () const;
+
+  /**
+   * \brief Get the name (from the interned table)
+   */
+  Ptr<const Name>
+  GetName () const;
+
+  /**
+   * \brief Get packet info, parsing NDN header only if packet has not been tagged yet
+   *
+   * The result is attached to the packet, so subsequent calls on the packet or any
+   * of its copies are served from the tag
+   */
+  static V2vPacketInfoTag
+  Get (Ptr<const Packet> packet);
+
+  /**
+   * \brief Attach info obtained elsewhere (e.g., from already parsed header) to the packet,
+   * unless the packet is already tagged
+   */
+  static void
+  Attach (Ptr<const Packet> packet, HeaderHelper::Type type, const Name &name);
+
+  /**
+   * \brief Get id for the name, adding the name to the intern table if necessary
+   */
+  static uint32_t
+  InternName (const Name &name);
+
+  /**
+   * \brief Get name from the intern table
+   */
+  static Ptr<const Name>
+  GetInternedName (uint32_t nameId);
+
+  // from Tag
+  virtual uint32_t
+  GetSerializedSize () const;
+
+  virtual void
+  Serialize (TagBuffer i) const;
+
+  virtual void
+  Deserialize (TagBuffer i);
+
+  virtual void
+  Print (std::ostream &os) const;
+
+private:
+  static HeaderHelper::Type
+  NormalizeType (HeaderHelper::Type type);
+
+private:
+  uint8_t m_type;
+  uint32_t m_nameId;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_PACKET_INFO_TAG_H
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-propagation-front.h"
+
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+#include <cmath>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.V2vPropagationFront");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vPropagationFront);
+
+TypeId
+V2vPropagationFront::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::V2vPropagationFront")
+    .SetParent<Object> ()
+    .AddConstructor<V2vPropagationFront> ()
+
+    .AddTraceSource ("Advance", "Front of the item has advanced (name id, direction, distance from the origin, average speed)",
+                     MakeTraceSourceAccessor (&V2vPropagationFront::m_advanceTrace))
+    ;
+  return tid;
+}
+
+V2vPropagationFront::V2vPropagationFront ()
+{
+}
+
+bool
+V2vPropagationFront::Update (uint32_t nameId, const Vector &origin, const Vector &to)
+{
+  if (nameId >= m_items.size ())
+    {
+      Item item;
+      item.m_observed = false;
+      m_items.resize (nameId + 1, item);
+    }
+
+  Item &item = m_items[nameId];
+  if (!item.m_observed)
+    {
+      item.m_observed = true;
+      item.m_origin = origin.x;
+      item.m_start = Simulator::Now ();
+      for (int direction = FORWARD; direction <= BACKWARD; direction++)
+        {
+          item.m_fronts[direction].m_distance = 0;
+          item.m_fronts[direction].m_advanced = item.m_start;
+        }
+    }
+
+  double offset = to.x - item.m_origin;
+  Direction direction = offset >= 0 ? FORWARD : BACKWARD;
+
+  Front &front = item.m_fronts[direction];
+  if (std::abs (offset) <= front.m_distance)
+    return false;
+
+  front.m_distance = std::abs (offset);
+  front.m_advanced = Simulator::Now ();
+
+  NS_LOG_DEBUG ("Item " << nameId << ", direction " << direction << ": " << front.m_distance << "m");
+  m_advanceTrace (nameId, direction, front.m_distance, GetSpeed (nameId, direction));
+  return true;
+}
+
+double
+V2vPropagationFront::GetOffset (uint32_t nameId, const Vector &position) const
+{
+  if (nameId >= m_items.size () || !m_items[nameId].m_observed)
+    return 0;
+
+  return position.x - m_items[nameId].m_origin;
+}
+
+double
+V2vPropagationFront::GetDistance (uint32_t nameId, Direction direction) const
+{
+  if (nameId >= m_items.size () || !m_items[nameId].m_observed)
+    return 0;
+
+  return m_items[nameId].m_fronts[direction].m_distance;
+}
+
+double
+V2vPropagationFront::GetSpeed (uint32_t nameId, Direction direction) const
+{
+  if (nameId >= m_items.size () || !m_items[nameId].m_observed)
+    return 0;
+
+  const Item &item = m_items[nameId];
+  double elapsed = (item.m_fronts[direction].m_advanced - item.m_start).ToDouble (Time::S);
+  if (elapsed <= 0)
+    return 0;
+
+  return item.m_fronts[direction].m_distance / elapsed;
+}
+
+void
+V2vPropagationFront::Reset ()
+{
+  m_items.clear ();
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_PROPAGATION_FRONT_H
+#define V2V_PROPAGATION_FRONT_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/traced-callback.h"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief Tracks how far every data item has propagated along the highway in each direction
+ *
+ * Front of the item is the largest distance (along the x axis) from the origin of the item,
+ * where the origin is the position given with the first observed reception of the item
+ * (the data source, if known, so that all MPI ranks measure fronts from the same point).
+ * Fronts are tracked separately for each item (interned name id, see V2vPacketInfoTag) and
+ * each direction (towards larger or smaller x), in O(1) per reception.
+ *
+ * Average front speed (distance of the front from the origin divided by time since the item
+ * was first observed) is updated every time the front advances and reported through the
+ * Advance trace source.
+ */
+class V2vPropagationFront : public Object
+{
+public:
+  static TypeId
+  GetTypeId ();
+
+  enum Direction
+    {
+      FORWARD = 0,  ///< \brief towards larger x
+      BACKWARD = 1  ///< \brief towards smaller x
+    };
+
+  V2vPropagationFront ();
+
+  /**
+   * \brief Record reception of the item
+   * \param nameId   interned name of the item
+   * \param origin   position of the data source (GeoSrcTag) or, if unknown, of the transmitter;
+   *                 used only on the first reception of the item
+   * \param to       position of the receiver
+   * \returns true if the reception advanced the front of the item
+   */
+  bool
+  Update (uint32_t nameId, const Vector &origin, const Vector &to);
+
+  /**
+   * \brief Get signed distance along the x axis from the origin of the item to the position
+   *        (positive in FORWARD direction, 0 if the item has not been observed)
+   */
+  double
+  GetOffset (uint32_t nameId, const Vector &position) const;
+
+  /**
+   * \brief Get distance from the origin to the front of the item (0 if not observed)
+   */
+  double
+  GetDistance (uint32_t nameId, Direction direction) const;
+
+  /**
+   * \brief Get average speed of the front of the item, meters per second (0 if not observed)
+   */
+  double
+  GetSpeed (uint32_t nameId, Direction direction) const;
+
+  /**
+   * \brief Forget all items (e.g., before the next run in the same process)
+   */
+  void
+  Reset ();
+
+private:
+  struct Front
+  {
+    double m_distance;
+    Time m_advanced; ///< \brief when the front has been advanced last time
+  };
+
+  struct Item
+  {
+    bool m_observed;
+    double m_origin;
+    Time m_start;
+    Front m_fronts[2];
+  };
+
+  // name ids are small consecutive numbers, so direct indexing is used
+  std::vector<Item> m_items;
+
+  TracedCallback<uint32_t, int, double, double> m_advanceTrace;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_PROPAGATION_FRONT_H
@@ -0,0 +1,234 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-remote-frame-header.h"
+#include "v2v-packet-info-tag.h"
+
+#include "ns3/packet.h"
+#include "ns3/tag.h"
+#include "ns3/address-utils.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("ndn.V2vRemoteFrameHeader");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vRemoteFrameHeader);
+
+TypeId
+V2vRemoteFrameHeader::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::V2vRemoteFrameHeader")
+    .SetParent<Header> ()
+    .AddConstructor<V2vRemoteFrameHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+V2vRemoteFrameHeader::GetInstanceTypeId () const
+{
+  return V2vRemoteFrameHeader::GetTypeId ();
+}
+
+V2vRemoteFrameHeader::V2vRemoteFrameHeader ()
+  : m_protocol (0)
+  , m_decodable (false)
+{
+}
+
+void
+V2vRemoteFrameHeader::SetProtocol (uint16_t protocol)
+{
+  m_protocol = protocol;
+}
+
+uint16_t
+V2vRemoteFrameHeader::GetProtocol () const
+{
+  return m_protocol;
+}
+
+void
+V2vRemoteFrameHeader::SetFrom (const Mac48Address &from)
+{
+  m_from = from;
+}
+
+const Mac48Address &
+V2vRemoteFrameHeader::GetFrom () const
+{
+  return m_from;
+}
+
+void
+V2vRemoteFrameHeader::SetDuration (const Time &duration)
+{
+  m_duration = duration;
+}
+
+const Time &
+V2vRemoteFrameHeader::GetDuration () const
+{
+  return m_duration;
+}
+
+void
+V2vRemoteFrameHeader::SetDecodable (bool decodable)
+{
+  m_decodable = decodable;
+}
+
+bool
+V2vRemoteFrameHeader::IsDecodable () const
+{
+  return m_decodable;
+}
+
+void
+V2vRemoteFrameHeader::TakePacketTags (Ptr<Packet> packet)
+{
+  PacketTagIterator i = packet->GetPacketTagIterator ();
+  while (i.HasNext ())
+    {
+      PacketTagIterator::Item item = i.Next ();
+      TypeId tid = item.GetTypeId ();
+      if (tid == V2vPacketInfoTag::GetTypeId ())
+        {
+          // name id is only valid in this rank's intern table, the receiving rank re-parses the packet
+          continue;
+        }
+
+      if (!tid.HasConstructor ())
+        {
+          NS_LOG_WARN ("Tag " << tid.GetName () << " cannot be transferred to another rank (no constructor)");
+          continue;
+        }
+
+      Tag *tag = dynamic_cast<Tag*> (tid.GetConstructor () ());
+      NS_ASSERT (tag != 0);
+      item.GetTag (*tag);
+
+      SerializedTag serialized;
+      serialized.m_typeId = tid.GetName ();
+      serialized.m_data.resize (tag->GetSerializedSize ());
+      if (!serialized.m_data.empty ())
+        {
+          tag->Serialize (TagBuffer (&serialized.m_data[0], &serialized.m_data[0] + serialized.m_data.size ()));
+        }
+      delete tag;
+
+      m_tags.push_back (serialized);
+    }
+
+  packet->RemoveAllPacketTags ();
+}
+
+void
+V2vRemoteFrameHeader::RestorePacketTags (Ptr<Packet> packet) const
+{
+  for (std::vector<SerializedTag>::const_iterator i = m_tags.begin (); i != m_tags.end (); i++)
+    {
+      Tag *tag = dynamic_cast<Tag*> (TypeId::LookupByName (i->m_typeId).GetConstructor () ());
+      NS_ASSERT (tag != 0);
+
+      if (!i->m_data.empty ())
+        {
+          uint8_t *data = const_cast<uint8_t*> (&i->m_data[0]);
+          tag->Deserialize (TagBuffer (data, data + i->m_data.size ()));
+        }
+      packet->AddPacketTag (*tag);
+      delete tag;
+    }
+}
+
+uint32_t
+V2vRemoteFrameHeader::GetSerializedSize () const
+{
+  uint32_t size = 2 /*protocol*/ + 6 /*from*/ + 8 /*duration*/ + 1 /*decodable*/ + 1 /*tag count*/;
+  for (std::vector<SerializedTag>::const_iterator i = m_tags.begin (); i != m_tags.end (); i++)
+    {
+      size += 1 + i->m_typeId.size () + 2 + i->m_data.size ();
+    }
+  return size;
+}
+
+void
+V2vRemoteFrameHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+
+  i.WriteHtonU16 (m_protocol);
+  WriteTo (i, m_from);
+  i.WriteHtonU64 (m_duration.GetNanoSeconds ());
+  i.WriteU8 (m_decodable ? 1 : 0);
+
+  NS_ASSERT (m_tags.size () < 256);
+  i.WriteU8 (m_tags.size ());
+  for (std::vector<SerializedTag>::const_iterator tag = m_tags.begin (); tag != m_tags.end (); tag++)
+    {
+      i.WriteU8 (tag->m_typeId.size ());
+      i.Write (reinterpret_cast<const uint8_t*> (tag->m_typeId.c_str ()), tag->m_typeId.size ());
+      i.WriteHtonU16 (tag->m_data.size ());
+      if (!tag->m_data.empty ())
+        {
+          i.Write (&tag->m_data[0], tag->m_data.size ());
+        }
+    }
+}
+
+uint32_t
+V2vRemoteFrameHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+
+  m_protocol = i.ReadNtohU16 ();
+  ReadFrom (i, m_from);
+  m_duration = NanoSeconds (i.ReadNtohU64 ());
+  m_decodable = i.ReadU8 () != 0;
+
+  m_tags.resize (i.ReadU8 ());
+  for (std::vector<SerializedTag>::iterator tag = m_tags.begin (); tag != m_tags.end (); tag++)
+    {
+      tag->m_typeId.resize (i.ReadU8 ());
+      if (!tag->m_typeId.empty ())
+        {
+          i.Read (reinterpret_cast<uint8_t*> (&tag->m_typeId[0]), tag->m_typeId.size ());
+        }
+      tag->m_data.resize (i.ReadNtohU16 ());
+      if (!tag->m_data.empty ())
+        {
+          i.Read (&tag->m_data[0], tag->m_data.size ());
+        }
+    }
+
+  return i.GetDistanceFrom (start);
+}
+
+void
+V2vRemoteFrameHeader::Print (std::ostream &os) const
+{
+  os << "protocol=" << m_protocol << ", from=" << m_from << ", duration=" << m_duration.GetNanoSeconds () << "ns"
+     << ", decodable=" << m_decodable << ", tags=" << m_tags.size ();
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_REMOTE_FRAME_HEADER_H
+#define V2V_REMOTE_FRAME_HEADER_H
+
+#include "ns3/header.h"
+#include "ns3/nstime.h"
+#include "ns3/mac48-address.h"
+
+#include <vector>
+#include <string>
+
+namespace ns3 {
+
+class Packet;
+
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief Header that carries V2vBroadcastChannel frame to the receiver simulated by another MPI rank
+ *
+ * In addition to the reception parameters (protocol, sender, airtime, and whether the frame is
+ * decodable), header carries all packet tags of the frame, because packet tags are not part
+ * of the serialized packet.  Only tags that have registered constructor are transferred.
+ */
+class V2vRemoteFrameHeader : public Header
+{
+public:
+  static TypeId
+  GetTypeId ();
+
+  virtual TypeId
+  GetInstanceTypeId () const;
+
+  V2vRemoteFrameHeader ();
+
+  void
+  SetProtocol (uint16_t protocol);
+
+  uint16_t
+  GetProtocol () const;
+
+  void
+  SetFrom (const Mac48Address &from);
+
+  const Mac48Address &
+  GetFrom () const;
+
+  void
+  SetDuration (const Time &duration);
+
+  const Time &
+  GetDuration () const;
+
+  void
+  SetDecodable (bool decodable);
+
+  bool
+  IsDecodable () const;
+
+  /**
+   * \brief Move all packet tags of \p packet into the header
+   *
+   * V2vPacketInfoTag is dropped, as interned name ids are local to the rank
+   */
+  void
+  TakePacketTags (Ptr<Packet> packet);
+
+  /**
+   * \brief Restore packet tags stored in the header on \p packet
+   */
+  void
+  RestorePacketTags (Ptr<Packet> packet) const;
+
+  // from Header
+  virtual uint32_t
+  GetSerializedSize () const;
+
+  virtual void
+  Serialize (Buffer::Iterator start) const;
+
+  virtual uint32_t
+  Deserialize (Buffer::Iterator start);
+
+  virtual void
+  Print (std::ostream &os) const;
+
+private:
+  struct SerializedTag
+  {
+    std::string m_typeId;
+    std::vector<uint8_t> m_data;
+  };
+
+  uint16_t m_protocol;
+  Mac48Address m_from;
+  Time m_duration;
+  bool m_decodable;
+  std::vector<SerializedTag> m_tags;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_REMOTE_FRAME_HEADER_H
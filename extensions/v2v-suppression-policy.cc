@@ -0,0 +1,186 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-suppression-policy.h"
+
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/vector.h"
+
+#include <cmath>
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vSuppressionPolicy);
+NS_OBJECT_ENSURE_REGISTERED (V2vDistanceSuppressionPolicy);
+NS_OBJECT_ENSURE_REGISTERED (V2vCounterSuppressionPolicy);
+NS_OBJECT_ENSURE_REGISTERED (V2vCoverageSuppressionPolicy);
+
+V2vSuppressionPolicy::Overheard::Overheard ()
+  : m_count (0)
+  , m_transmitters (0)
+  , m_hasSource (false)
+  , m_hasTransmitter (false)
+  , m_hasPosition (false)
+{
+}
+
+TypeId
+V2vSuppressionPolicy::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::V2vSuppressionPolicy")
+    .SetParent<Object> ()
+    ;
+  return tid;
+}
+
+V2vSuppressionPolicy::~V2vSuppressionPolicy ()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TypeId
+V2vDistanceSuppressionPolicy::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::V2vDistanceSuppressionPolicy")
+    .SetParent<V2vSuppressionPolicy> ()
+    .AddConstructor<V2vDistanceSuppressionPolicy> ()
+    ;
+  return tid;
+}
+
+bool
+V2vDistanceSuppressionPolicy::ShouldCancel (const Overheard &overheard)
+{
+  //   src  -----   <transmission>  ---- <mobility>
+  if (overheard.m_hasPosition && overheard.m_hasSource && overheard.m_hasTransmitter)
+    {
+      return CalculateDistance (overheard.m_source, overheard.m_transmitter) >=
+        CalculateDistance (overheard.m_source, overheard.m_position);
+    }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TypeId
+V2vCounterSuppressionPolicy::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::V2vCounterSuppressionPolicy")
+    .SetParent<V2vSuppressionPolicy> ()
+    .AddConstructor<V2vCounterSuppressionPolicy> ()
+
+    .AddAttribute ("Threshold", "Number of overheard copies of the name after which queued transmission is cancelled",
+                   UintegerValue (3),
+                   MakeUintegerAccessor (&V2vCounterSuppressionPolicy::m_threshold),
+                   MakeUintegerChecker<uint32_t> (1))
+    ;
+  return tid;
+}
+
+bool
+V2vCounterSuppressionPolicy::ShouldCancel (const Overheard &overheard)
+{
+  return overheard.m_count >= m_threshold;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TypeId
+V2vCoverageSuppressionPolicy::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::V2vCoverageSuppressionPolicy")
+    .SetParent<V2vSuppressionPolicy> ()
+    .AddConstructor<V2vCoverageSuppressionPolicy> ()
+
+    .AddAttribute ("Range", "Assumed transmission range",
+                   DoubleValue (250.0),
+                   MakeDoubleAccessor (&V2vCoverageSuppressionPolicy::m_range),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Threshold", "Transmission is cancelled if the points not yet covered by the overheard transmitters are "
+                   "less than this fraction of the sample points of the node's own range (segment along RoadAxis, or circle)",
+                   DoubleValue (0.2),
+                   MakeDoubleAccessor (&V2vCoverageSuppressionPolicy::m_threshold),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("Samples", "Number of points at which coverage is estimated",
+                   UintegerValue (16),
+                   MakeUintegerAccessor (&V2vCoverageSuppressionPolicy::m_samples),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("RoadAxis", "Direction of the road, coverage is estimated along the road within Range from the node "
+                   "(zero vector: over the circle of Range radius, for two-dimensional road networks)",
+                   VectorValue (Vector (1.0, 0.0, 0.0)),
+                   MakeVectorAccessor (&V2vCoverageSuppressionPolicy::m_roadAxis),
+                   MakeVectorChecker ())
+    ;
+  return tid;
+}
+
+bool
+V2vCoverageSuppressionPolicy::ShouldCancel (const Overheard &overheard)
+{
+  if (!overheard.m_hasPosition)
+    return true;
+
+  if (overheard.m_transmitters == 0 || overheard.m_transmitters->empty ())
+    return false; // nothing is known about the coverage
+
+  // transmitter positions are two-dimensional (see GeoTag)
+  double axisLength = std::sqrt (m_roadAxis.x * m_roadAxis.x + m_roadAxis.y * m_roadAxis.y);
+
+  uint32_t uncovered = 0;
+  for (uint32_t i = 0; i < m_samples; i++)
+    {
+      double x, y;
+      if (axisLength > 0)
+        {
+          // middles of Samples equal pieces of the road segment [-Range, Range] around the node
+          double offset = m_range * (2.0 * (i + 0.5) / m_samples - 1.0);
+          x = overheard.m_position.x + offset * m_roadAxis.x / axisLength;
+          y = overheard.m_position.y + offset * m_roadAxis.y / axisLength;
+        }
+      else
+        {
+          double angle = 2 * M_PI * i / m_samples;
+          x = overheard.m_position.x + m_range * std::cos (angle);
+          y = overheard.m_position.y + m_range * std::sin (angle);
+        }
+
+      bool covered = false;
+      for (std::vector<Vector>::const_iterator transmitter = overheard.m_transmitters->begin ();
+           !covered && transmitter != overheard.m_transmitters->end ();
+           transmitter++)
+        {
+          double dx = x - transmitter->x;
+          double dy = y - transmitter->y;
+          covered = dx * dx + dy * dy <= m_range * m_range;
+        }
+
+      if (!covered)
+        uncovered ++;
+    }
+
+  return uncovered < m_threshold * m_samples;
+}
+
+} // namespace ndn
+} // namespace ns3
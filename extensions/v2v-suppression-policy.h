@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_SUPPRESSION_POLICY_H
+#define V2V_SUPPRESSION_POLICY_H
+
+#include "ns3/object.h"
+#include "ns3/vector.h"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief Policy that decides whether queued transmission is cancelled when the same name is overheard
+ *
+ * Policy is consulted by V2vNetDeviceFace for every queued item with the overheard name.
+ * Suppressed items (Data and Interests) are removed from the queue and reported through
+ * CancelingData trace source, the rest are counted as ignored cancellations
+ * (see V2vFaceStats).
+ *
+ * Policy is selected by V2vNetDeviceFace::SuppressionPolicy attribute
+ */
+class V2vSuppressionPolicy : public Object
+{
+public:
+  /**
+   * \brief What is known about the overheard packet and the previous overhearings of the same name
+   */
+  struct Overheard
+  {
+    Overheard ();
+
+    uint32_t m_count;      ///< \brief how many times the name has been overheard while the item was waiting (including this time)
+    const std::vector<Vector> *m_transmitters; ///< \brief positions of the transmitters of all overheard copies of the name (including this one)
+
+    bool m_hasSource;      ///< \brief whether position of the data source is known (GeoSrcTag)
+    Vector m_source;
+    bool m_hasTransmitter; ///< \brief whether position of the transmitter is known (GeoTransmissionTag)
+    Vector m_transmitter;
+    bool m_hasPosition;    ///< \brief whether position of this node is known (mobility model is installed)
+    Vector m_position;
+  };
+
+  static TypeId
+  GetTypeId ();
+
+  virtual ~V2vSuppressionPolicy ();
+
+  /**
+   * \brief Check if the queued transmission should be cancelled
+   */
+  virtual bool
+  ShouldCancel (const Overheard &overheard) = 0;
+};
+
+/**
+ * \ingroup Ndn
+ * \brief Cancel unless the transmitter is closer to the data source than this node (the original cancellation)
+ *
+ * Transmission is cancelled after the first overhearing from a node farther from the source,
+ * duplicates from the nodes behind do not affect it at all
+ */
+class V2vDistanceSuppressionPolicy : public V2vSuppressionPolicy
+{
+public:
+  static TypeId
+  GetTypeId ();
+
+  virtual bool
+  ShouldCancel (const Overheard &overheard);
+};
+
+/**
+ * \ingroup Ndn
+ * \brief Cancel after the name has been overheard Threshold times, regardless of where transmitters are
+ */
+class V2vCounterSuppressionPolicy : public V2vSuppressionPolicy
+{
+public:
+  static TypeId
+  GetTypeId ();
+
+  virtual bool
+  ShouldCancel (const Overheard &overheard);
+
+private:
+  uint32_t m_threshold;
+};
+
+/**
+ * \ingroup Ndn
+ * \brief Cancel when overheard transmitters already cover almost everything this node's transmission would cover
+ *
+ * Additional coverage is estimated at Samples points evenly spread along the road (RoadAxis)
+ * within Range from the node, or, if RoadAxis is zero, over the circle of Range radius around
+ * the node (the area farthest from the node is the last one to be covered).  On a highway
+ * the circle is a biased estimate: points across the road are never covered by transmitters
+ * on the road.  A point is covered if it is within Range from any of the overheard transmitters.  The
+ * transmission is cancelled when the fraction of uncovered points falls below Threshold.
+ * If position of this node is unknown, transmission is cancelled right away.
+ */
+class V2vCoverageSuppressionPolicy : public V2vSuppressionPolicy
+{
+public:
+  static TypeId
+  GetTypeId ();
+
+  virtual bool
+  ShouldCancel (const Overheard &overheard);
+
+private:
+  double m_range;
+  double m_threshold;
+  uint32_t m_samples;
+  Vector m_roadAxis;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_SUPPRESSION_POLICY_H
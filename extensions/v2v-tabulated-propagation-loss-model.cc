@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-tabulated-propagation-loss-model.h"
+
+#include "ns3/mobility-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/log.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <boost/math/special_functions/gamma.hpp>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.V2vTabulatedPropagationLossModel");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED (V2vTabulatedPropagationLossModel);
+
+TypeId
+V2vTabulatedPropagationLossModel::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ndn::V2vTabulatedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .AddConstructor<V2vTabulatedPropagationLossModel> ()
+
+    .AddAttribute ("TableStep", "Distance resolution of the mean loss table (m)",
+                   DoubleValue (0.5),
+                   MakeDoubleAccessor (&V2vTabulatedPropagationLossModel::m_tableStep),
+                   MakeDoubleChecker<double> (0.001))
+    .AddAttribute ("MaxDistance", "Distance up to which mean loss is tabulated (m), original model is evaluated beyond it",
+                   DoubleValue (2000.0),
+                   MakeDoubleAccessor (&V2vTabulatedPropagationLossModel::m_maxDistance),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("FadingTableSize", "Number of quantile bins in the fading inverse CDF tables",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&V2vTabulatedPropagationLossModel::m_fadingTableSize),
+                   MakeUintegerChecker<uint32_t> (4))
+    ;
+  return tid;
+}
+
+V2vTabulatedPropagationLossModel::V2vTabulatedPropagationLossModel ()
+  : m_distance0 (0)
+{
+}
+
+double
+V2vTabulatedPropagationLossModel::GetDoubleAttribute (Ptr<Object> object, const std::string &name) const
+{
+  DoubleValue value;
+  object->GetAttribute (name, value);
+  return value.Get ();
+}
+
+double
+V2vTabulatedPropagationLossModel::GetExactFadingGain (double m, double u)
+{
+  // Nakagami power gain is Gamma(m, 1/m) distributed
+  u = std::max (u, std::numeric_limits<double>::min ());
+  return 10 * std::log10 (boost::math::gamma_p_inv (m, u) / m);
+}
+
+void
+V2vTabulatedPropagationLossModel::Initialize () const
+{
+  if (m_threeLogDistance != 0)
+    return;
+
+  m_threeLogDistance = CreateObject<ThreeLogDistancePropagationLossModel> ();
+  m_distance0 = GetDoubleAttribute (m_threeLogDistance, "Distance0");
+  m_origin = CreateObject<ConstantPositionMobilityModel> ();
+  m_point = CreateObject<ConstantPositionMobilityModel> ();
+
+  uint32_t size = static_cast<uint32_t> (std::ceil (m_maxDistance / m_tableStep)) + 1;
+  m_meanLoss.resize (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      m_point->SetPosition (Vector (i * m_tableStep, 0, 0));
+      m_meanLoss[i] = -m_threeLogDistance->CalcRxPower (0, m_origin, m_point);
+    }
+
+  Ptr<PropagationLossModel> nakagami = CreateObject<NakagamiPropagationLossModel> ();
+  m_fadingDistance[0] = GetDoubleAttribute (nakagami, "Distance1");
+  m_fadingDistance[1] = GetDoubleAttribute (nakagami, "Distance2");
+  m_m[0] = GetDoubleAttribute (nakagami, "m0");
+  m_m[1] = GetDoubleAttribute (nakagami, "m1");
+  m_m[2] = GetDoubleAttribute (nakagami, "m2");
+
+  for (uint32_t k = 0; k < 3; k++)
+    {
+      m_fadingGain[k].resize (m_fadingTableSize + 1);
+      for (uint32_t i = 1; i < m_fadingTableSize; i++)
+        {
+          m_fadingGain[k][i] = GetExactFadingGain (m_m[k], static_cast<double> (i) / m_fadingTableSize);
+        }
+    }
+
+  NS_LOG_DEBUG ("Tabulated " << size << " mean loss values and 3 x " << m_fadingTableSize << " fading quantiles");
+}
+
+double
+V2vTabulatedPropagationLossModel::GetMeanLoss (double distance) const
+{
+  Initialize ();
+
+  double position = distance / m_tableStep;
+  uint32_t i = static_cast<uint32_t> (position);
+
+  // the original model is discontinuous at Distance0, do not interpolate across it
+  if (distance < m_distance0 + m_tableStep || i + 1 >= m_meanLoss.size ())
+    {
+      m_point->SetPosition (Vector (distance, 0, 0));
+      return -m_threeLogDistance->CalcRxPower (0, m_origin, m_point);
+    }
+
+  double fraction = position - i;
+  return m_meanLoss[i] + fraction * (m_meanLoss[i + 1] - m_meanLoss[i]);
+}
+
+double
+V2vTabulatedPropagationLossModel::GetFadingGain (double distance, double u) const
+{
+  Initialize ();
+
+  uint32_t k = (distance < m_fadingDistance[0]) ? 0 : ((distance < m_fadingDistance[1]) ? 1 : 2);
+
+  double position = u * m_fadingTableSize;
+  uint32_t i = static_cast<uint32_t> (position);
+
+  // tails are too steep to interpolate
+  if (i == 0 || i + 1 >= m_fadingTableSize)
+    {
+      return GetExactFadingGain (m_m[k], u);
+    }
+
+  double fraction = position - i;
+  return m_fadingGain[k][i] + fraction * (m_fadingGain[k][i + 1] - m_fadingGain[k][i]);
+}
+
+double
+V2vTabulatedPropagationLossModel::DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  double distance = a->GetDistanceFrom (b);
+  return txPowerDbm - GetMeanLoss (distance) + GetFadingGain (distance, m_uniform.GetValue ());
+}
+
+int64_t
+V2vTabulatedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  // fading is drawn from the global RNG (old RandomVariable API), no streams are used
+  return 0;
+}
+
+} // namespace ndn
+} // namespace ns3
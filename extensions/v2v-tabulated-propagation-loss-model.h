@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_TABULATED_PROPAGATION_LOSS_MODEL_H
+#define V2V_TABULATED_PROPAGATION_LOSS_MODEL_H
+
+#include "ns3/propagation-loss-model.h"
+#include "ns3/random-variable.h"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief ThreeLogDistance + Nakagami propagation loss evaluated using precomputed tables
+ *
+ * Mean loss of ThreeLogDistancePropagationLossModel is tabulated (on the first use) for
+ * distances up to MaxDistance with TableStep resolution and linearly interpolated.  The
+ * table is filled by the original model, so the model configuration is picked up from its
+ * attribute defaults.  Beyond MaxDistance the original model is evaluated.
+ *
+ * Nakagami fading gain is drawn by inverting the tabulated CDF of Gamma(m, 1/m) for each
+ * of the three m values of NakagamiPropagationLossModel: a uniform sample selects the
+ * quantile bin, and the gain is interpolated within the bin.  The first and the last bins,
+ * which contain the tails of the distribution, are inverted exactly.
+ *
+ * Use v2v-loss-model-validation scenario to compare the model with the original chain.
+ */
+class V2vTabulatedPropagationLossModel : public PropagationLossModel
+{
+public:
+  static TypeId
+  GetTypeId ();
+
+  V2vTabulatedPropagationLossModel ();
+
+  /**
+   * \brief Get tabulated mean loss (dB) at distance \p distance, without fading
+   */
+  double
+  GetMeanLoss (double distance) const;
+
+  /**
+   * \brief Get tabulated fading gain (dB) for the quantile \p u of the fading distribution at distance \p distance
+   */
+  double
+  GetFadingGain (double distance, double u) const;
+
+private:
+  // from PropagationLossModel
+  virtual double
+  DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
+  virtual int64_t
+  DoAssignStreams (int64_t stream);
+
+  /// \brief Create the original models and fill the tables (done on the first use)
+  void
+  Initialize () const;
+
+  double
+  GetDoubleAttribute (Ptr<Object> object, const std::string &name) const;
+
+  /// \brief Get exact Nakagami gain (dB) for the quantile \p u
+  static double
+  GetExactFadingGain (double m, double u);
+
+private:
+  double m_tableStep;
+  double m_maxDistance;
+  uint32_t m_fadingTableSize;
+
+  mutable Ptr<PropagationLossModel> m_threeLogDistance;
+  mutable Ptr<MobilityModel> m_origin;
+  mutable Ptr<MobilityModel> m_point;
+
+  mutable double m_distance0;
+  mutable std::vector<double> m_meanLoss;
+
+  // parameters of Nakagami model
+  mutable double m_fadingDistance[2];
+  mutable double m_m[3];
+  mutable std::vector<double> m_fadingGain[3]; ///< \brief fading gain (dB) at quantiles i / FadingTableSize
+
+  mutable UniformVariable m_uniform;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_TABULATED_PROPAGATION_LOSS_MODEL_H
@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_TRACE_RING_BUFFER_H
+#define V2V_TRACE_RING_BUFFER_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/atomic.hpp>
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief Bounded lock-free queue for exactly one producer thread and one consumer thread
+ *
+ * Used to pass trace records from the simulation thread to the writer thread (see
+ * V2vTraceWriter).  Push and pop never block and never allocate: when the queue is full,
+ * TryPush fails and the producer decides what to do (wait or drop).
+ *
+ * Producer and consumer indexes are kept on different cache lines, so threads do not
+ * invalidate each other's cache unless they actually exchange items.
+ */
+template<class T>
+class V2vTraceRingBuffer : boost::noncopyable
+{
+public:
+  /**
+   * \brief Create queue
+   * \param capacity maximum number of items (rounded up to the power of two)
+   */
+  explicit
+  V2vTraceRingBuffer (size_t capacity)
+    : m_head (0)
+    , m_tail (0)
+  {
+    size_t size = 1;
+    while (size < capacity)
+      size <<= 1;
+
+    m_items.resize (size);
+    m_mask = size - 1;
+  }
+
+  /**
+   * \brief Add item to the queue (producer thread only)
+   * \returns false if the queue is full
+   */
+  bool
+  TryPush (const T &item)
+  {
+    size_t tail = m_tail.load (boost::memory_order_relaxed);
+    if (tail - m_head.load (boost::memory_order_acquire) > m_mask)
+      return false;
+
+    m_items[tail & m_mask] = item;
+    m_tail.store (tail + 1, boost::memory_order_release);
+    return true;
+  }
+
+  /**
+   * \brief Remove item from the queue (consumer thread only)
+   * \returns false if the queue is empty
+   */
+  bool
+  TryPop (T &item)
+  {
+    size_t head = m_head.load (boost::memory_order_relaxed);
+    if (head == m_tail.load (boost::memory_order_acquire))
+      return false;
+
+    item = m_items[head & m_mask];
+    m_head.store (head + 1, boost::memory_order_release);
+    return true;
+  }
+
+  /**
+   * \brief Get number of items in the queue (approximate if called while the other thread is active)
+   */
+  size_t
+  GetSize () const
+  {
+    return m_tail.load (boost::memory_order_acquire) - m_head.load (boost::memory_order_acquire);
+  }
+
+  size_t
+  GetCapacity () const
+  {
+    return m_mask + 1;
+  }
+
+private:
+  static const size_t CACHE_LINE = 64;
+
+  std::vector<T> m_items;
+  size_t m_mask;
+
+  char m_pad0[CACHE_LINE];
+  boost::atomic<size_t> m_head; ///< \brief next item to pop, written by consumer
+  char m_pad1[CACHE_LINE];
+  boost::atomic<size_t> m_tail; ///< \brief next free slot, written by producer
+  char m_pad2[CACHE_LINE];
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_TRACE_RING_BUFFER_H
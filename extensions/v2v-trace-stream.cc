@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-trace-stream.h"
+
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/concepts.hpp>
+#include <boost/iostreams/operations.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/make_shared.hpp>
+
+#include <fstream>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.V2vTraceStream");
+
+namespace ns3 {
+namespace ndn {
+
+static GlobalValue g_traceCodec ("V2vTraceCodec",
+                                 "Compression of the text traces: none, gzip, bzip2, or zlib",
+                                 StringValue ("none"),
+                                 MakeStringChecker ());
+
+static GlobalValue g_traceColumns ("V2vTraceColumns",
+                                   "Constant columns appended to every line of the text traces, e.g., Run=1,Distance=10",
+                                   StringValue (""),
+                                   MakeStringChecker ());
+
+static GlobalValue g_traceHeader ("V2vTraceHeader",
+                                  "Write header line of the text traces",
+                                  BooleanValue (true),
+                                  MakeBooleanChecker ());
+
+/**
+ * \brief Output filter that appends constant columns to every line and optionally drops the first (header) line
+ */
+class ConstantColumnsFilter : public boost::iostreams::output_filter
+{
+public:
+  ConstantColumnsFilter (const std::string &names, const std::string &values, bool header)
+    : m_names (names)
+    , m_values (values)
+    , m_header (header)
+    , m_firstLine (true)
+  {
+  }
+
+  template<typename Sink>
+  bool
+  put (Sink &sink, char c)
+  {
+    if (m_firstLine && !m_header)
+      {
+        if (c == '\n')
+          m_firstLine = false;
+        return true;
+      }
+
+    if (c == '\n')
+      {
+        const std::string &columns = m_firstLine ? m_names : m_values;
+        m_firstLine = false;
+
+        if (boost::iostreams::write (sink, columns.c_str (), columns.size ()) != static_cast<std::streamsize> (columns.size ()))
+          return false;
+      }
+
+    return boost::iostreams::put (sink, c);
+  }
+
+private:
+  std::string m_names;
+  std::string m_values;
+  bool m_header;
+  bool m_firstLine;
+};
+
+static std::string
+GetCodec ()
+{
+  StringValue codec;
+  g_traceCodec.GetValue (codec);
+  return codec.Get ();
+}
+
+std::string
+V2vTraceStream::GetExtension (bool binary)
+{
+  if (binary)
+    return ".v2vt";
+
+  std::string codec = GetCodec ();
+  if (codec == "gzip")
+    return ".txt.gz";
+  else if (codec == "bzip2")
+    return ".txt.bz2";
+  else if (codec == "zlib")
+    return ".txt.zlib";
+  else
+    return ".txt";
+}
+
+boost::shared_ptr<std::ostream>
+V2vTraceStream::Open (const std::string &file, bool binary)
+{
+  if (binary)
+    {
+      boost::shared_ptr<std::ofstream> os = boost::make_shared<std::ofstream> ();
+      os->open (file.c_str (), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+      if (!os->is_open ())
+        return boost::shared_ptr<std::ostream> ();
+
+      return os;
+    }
+
+  std::string codec = GetCodec ();
+
+  StringValue columnsValue;
+  g_traceColumns.GetValue (columnsValue);
+  std::string columns = columnsValue.Get ();
+
+  BooleanValue header;
+  g_traceHeader.GetValue (header);
+
+  if (codec == "none" && columns.empty () && header.Get ())
+    {
+      boost::shared_ptr<std::ofstream> os = boost::make_shared<std::ofstream> ();
+      os->open (file.c_str (), std::ios_base::out | std::ios_base::trunc);
+      if (!os->is_open ())
+        return boost::shared_ptr<std::ostream> ();
+
+      return os;
+    }
+
+  boost::iostreams::file_sink sink (file, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+  if (!sink.is_open ())
+    return boost::shared_ptr<std::ostream> ();
+
+  boost::shared_ptr<boost::iostreams::filtering_ostream> os = boost::make_shared<boost::iostreams::filtering_ostream> ();
+
+  // filters are applied in the order they are pushed
+  std::string names, values;
+  std::vector<std::string> pairs;
+  if (!columns.empty ())
+    boost::split (pairs, columns, boost::is_any_of (","));
+
+  for (std::vector<std::string>::const_iterator pair = pairs.begin (); pair != pairs.end (); pair++)
+    {
+      std::string::size_type eq = pair->find ('=');
+      NS_ASSERT_MSG (eq != std::string::npos, "V2vTraceColumns should be a list of name=value pairs");
+
+      names += "\t" + pair->substr (0, eq);
+      values += "\t" + pair->substr (eq + 1);
+    }
+  if (!pairs.empty () || !header.Get ())
+    os->push (ConstantColumnsFilter (names, values, header.Get ()));
+
+  if (codec == "gzip")
+    os->push (boost::iostreams::gzip_compressor ());
+  else if (codec == "bzip2")
+    os->push (boost::iostreams::bzip2_compressor ());
+  else if (codec == "zlib")
+    os->push (boost::iostreams::zlib_compressor ());
+  else
+    NS_ASSERT_MSG (codec == "none", "Unknown V2vTraceCodec " << codec);
+
+  os->push (sink);
+  return os;
+}
+
+} // namespace ndn
+} // namespace ns3
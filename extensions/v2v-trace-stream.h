@@ -0,0 +1,72 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_TRACE_STREAM_H
+#define V2V_TRACE_STREAM_H
+
+#include <boost/shared_ptr.hpp>
+
+#include <iostream>
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief Opens output streams for the trace files
+ *
+ * Text traces can be compressed on the fly and extended with constant columns, controlled
+ * by the global values (can be set from the command line, e.g., --V2vTraceCodec=bzip2):
+ * - V2vTraceCodec: none, gzip, bzip2, or zlib;
+ * - V2vTraceColumns: constant columns appended to every line, e.g., "Run=1,Distance=10"
+ *   (names are appended to the first line, which is the header);
+ * - V2vTraceHeader: whether to write the header line.
+ *
+ * gzip and bzip2 streams can be concatenated, so traces of several runs written with
+ * the run parameters as constant columns (and only one of them with the header) can be
+ * merged without decompressing them.
+ *
+ * Binary traces (see V2vTraceWriter) are not affected, as the reader needs random access
+ * to the file.
+ */
+class V2vTraceStream
+{
+public:
+  /**
+   * \brief Open trace file for writing
+   * \param file   file name (see GetExtension)
+   * \param binary open file for the binary trace
+   * \returns the stream, or null pointer if file cannot be opened
+   */
+  static boost::shared_ptr<std::ostream>
+  Open (const std::string &file, bool binary = false);
+
+  /**
+   * \brief Get extension for the trace file, e.g., ".txt.bz2" or ".v2vt"
+   */
+  static std::string
+  GetExtension (bool binary = false);
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_TRACE_STREAM_H
@@ -0,0 +1,302 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#include "v2v-trace-writer.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <boost/make_shared.hpp>
+
+#include <cstring>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.V2vTraceWriter");
+
+namespace ns3 {
+namespace ndn {
+
+static const char MAGIC[] = "V2VTRACE";
+static const uint16_t VERSION = 1;
+static const uint32_t TRAILER_MARKER = 0xFFFFFFFF;
+
+// how long the idle writer thread sleeps before checking the queue again
+static const boost::posix_time::milliseconds IDLE_WAIT (1);
+
+V2vTraceWriter::V2vTraceWriter (boost::shared_ptr<std::ostream> os, uint32_t blockSize)
+  : m_os (os)
+  , m_blockSize (blockSize)
+  , m_headerWritten (false)
+  , m_records (0)
+  , m_stopping (false)
+  , m_stalls (0)
+{
+  std::memset (&m_record, 0, sizeof (m_record));
+}
+
+V2vTraceWriter::~V2vTraceWriter ()
+{
+  if (m_thread.joinable ())
+    {
+      m_stopping.store (true, boost::memory_order_release);
+      m_wakeup.notify_one ();
+      m_thread.join ();
+
+      NS_LOG_INFO ("Writer thread waited for " << m_stalls << " records, queue capacity " << m_queue->GetCapacity ());
+    }
+
+  Flush ();
+
+  Write (TRAILER_MARKER);
+  Write (static_cast<uint32_t> (m_labels.size ()));
+  for (LabelMap::const_iterator label = m_labels.begin (); label != m_labels.end (); label++)
+    {
+      Write (static_cast<uint8_t> (label->first.first));
+      Write (label->first.second);
+      Write (static_cast<uint16_t> (label->second.size ()));
+      m_os->write (label->second.c_str (), label->second.size ());
+    }
+  m_os->flush ();
+}
+
+template<class T>
+void
+V2vTraceWriter::Write (const T &value)
+{
+  m_os->write (reinterpret_cast<const char*> (&value), sizeof (T));
+}
+
+uint32_t
+V2vTraceWriter::AddColumn (const std::string &name, ColumnType type)
+{
+  NS_ASSERT_MSG (!m_headerWritten, "Schema cannot be changed after the first record");
+  NS_ASSERT_MSG (m_columns.size () < MAX_COLUMNS, "Too many columns");
+
+  Column column;
+  column.m_name = name;
+  column.m_type = type;
+  m_columns.push_back (column);
+
+  return m_columns.size () - 1;
+}
+
+void
+V2vTraceWriter::AddLabel (uint32_t column, uint32_t value, const std::string &label)
+{
+  m_labels[std::make_pair (column, value)] = label;
+}
+
+bool
+V2vTraceWriter::HasLabel (uint32_t column, uint32_t value) const
+{
+  return m_labels.find (std::make_pair (column, value)) != m_labels.end ();
+}
+
+void
+V2vTraceWriter::SetTime (uint32_t column, const Time &time)
+{
+  if (column == NO_COLUMN)
+    return;
+
+  m_record.m_values[column].m_integer = time.GetNanoSeconds ();
+}
+
+void
+V2vTraceWriter::SetInteger (uint32_t column, int64_t value)
+{
+  if (column == NO_COLUMN)
+    return;
+
+  m_record.m_values[column].m_integer = value;
+}
+
+void
+V2vTraceWriter::SetDouble (uint32_t column, double value)
+{
+  if (column == NO_COLUMN)
+    return;
+
+  m_record.m_values[column].m_double = value;
+}
+
+template<class T>
+static void
+AppendValue (std::vector<char> &data, T value)
+{
+  size_t offset = data.size ();
+  data.resize (offset + sizeof (T));
+  std::memcpy (&data[offset], &value, sizeof (T));
+}
+
+void
+V2vTraceWriter::Commit ()
+{
+  if (m_queue)
+    {
+      if (!m_queue->TryPush (m_record))
+        {
+          // writer thread is behind, wait for it instead of growing memory
+          m_stalls ++;
+          m_wakeup.notify_one ();
+          while (!m_queue->TryPush (m_record))
+            {
+              boost::this_thread::yield ();
+            }
+        }
+    }
+  else
+    {
+      Append (m_record);
+    }
+
+  std::memset (&m_record, 0, sizeof (m_record));
+}
+
+void
+V2vTraceWriter::Append (const Record &record)
+{
+  for (uint32_t i = 0; i < m_columns.size (); i++)
+    {
+      std::vector<char> &data = m_columns[i].m_data;
+      const Value &value = record.m_values[i];
+
+      switch (m_columns[i].m_type)
+        {
+        case TIME:
+        case INT64:
+          AppendValue (data, value.m_integer);
+          break;
+        case UINT8:
+          AppendValue (data, static_cast<uint8_t> (value.m_integer));
+          break;
+        case UINT32:
+          AppendValue (data, static_cast<uint32_t> (value.m_integer));
+          break;
+        case FLOAT32:
+          AppendValue (data, static_cast<float> (value.m_double));
+          break;
+        case FLOAT64:
+          AppendValue (data, value.m_double);
+          break;
+        }
+    }
+
+  m_records ++;
+  if (m_records >= m_blockSize)
+    {
+      WriteBlock ();
+    }
+}
+
+void
+V2vTraceWriter::StartBackgroundThread (uint32_t queueSize)
+{
+  NS_ASSERT_MSG (!m_queue, "Writer thread is already started");
+
+  WriteHeader ();
+
+  m_queue = boost::make_shared< V2vTraceRingBuffer<Record> > (queueSize);
+  m_thread = boost::thread (&V2vTraceWriter::Run, this);
+}
+
+uint64_t
+V2vTraceWriter::GetStalls () const
+{
+  return m_stalls;
+}
+
+void
+V2vTraceWriter::Run ()
+{
+  Record record;
+  while (true)
+    {
+      // all records committed before the stop request are guaranteed to be in the queue
+      bool stopping = m_stopping.load (boost::memory_order_acquire);
+
+      boost::unique_lock<boost::mutex> lock (m_mutex);
+      bool processed = false;
+      while (m_queue->TryPop (record))
+        {
+          Append (record);
+          processed = true;
+        }
+
+      if (stopping)
+        break;
+
+      if (!processed)
+        {
+          m_wakeup.timed_wait (lock, IDLE_WAIT);
+        }
+    }
+}
+
+void
+V2vTraceWriter::WriteHeader ()
+{
+  m_os->write (MAGIC, sizeof (MAGIC) - 1);
+  Write (VERSION);
+  Write (static_cast<uint8_t> (m_columns.size ()));
+  for (std::vector<Column>::const_iterator column = m_columns.begin (); column != m_columns.end (); column++)
+    {
+      Write (static_cast<uint8_t> (column->m_type));
+      Write (static_cast<uint8_t> (column->m_name.size ()));
+      m_os->write (column->m_name.c_str (), column->m_name.size ());
+    }
+
+  m_headerWritten = true;
+}
+
+void
+V2vTraceWriter::Flush ()
+{
+  if (!m_headerWritten)
+    {
+      WriteHeader ();
+    }
+
+  if (m_thread.joinable ())
+    {
+      boost::lock_guard<boost::mutex> lock (m_mutex);
+      WriteBlock ();
+    }
+  else
+    {
+      WriteBlock ();
+    }
+}
+
+void
+V2vTraceWriter::WriteBlock ()
+{
+  if (m_records == 0)
+    return;
+
+  Write (m_records);
+  for (std::vector<Column>::iterator column = m_columns.begin (); column != m_columns.end (); column++)
+    {
+      m_os->write (&column->m_data[0], column->m_data.size ());
+      column->m_data.clear ();
+    }
+  m_records = 0;
+}
+
+} // namespace ndn
+} // namespace ns3
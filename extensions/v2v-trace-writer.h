@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+#ifndef V2V_TRACE_WRITER_H
+#define V2V_TRACE_WRITER_H
+
+#include "ns3/nstime.h"
+
+#include "v2v-trace-ring-buffer.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup Ndn
+ * \brief Buffered writer of the binary columnar trace format
+ *
+ * Records are accumulated in memory column by column and written in blocks.  File layout
+ * (numbers are in the host byte order, i.e., little-endian on x86):
+ *
+ *   "V2VTRACE" u16:version u8:columns { u8:type u8:length name }*
+ *   block*: u32:records { values of the column (records x size of the type) }* per column
+ *   trailer: u32:0xFFFFFFFF u32:labels { u8:column u32:value u16:length label }*
+ *
+ * Labels map integer values of a column (event codes, name ids) to strings.  Trailer is
+ * written when the writer is destroyed, so labels can be added during the simulation.
+ *
+ * Use v2v-trace-to-tsv.py to convert the file to the tab-separated text.
+ *
+ * After StartBackgroundThread, Commit only copies the fixed-size record into a lock-free
+ * queue (V2vTraceRingBuffer); packing into columns and disk writes are done by a separate
+ * thread, off the simulation event loop.  The queue is bounded: when the writer thread falls
+ * behind, Commit waits for a free slot (back-pressure), and such waits are counted
+ * (see GetStalls).
+ */
+class V2vTraceWriter : boost::noncopyable
+{
+public:
+  /// \brief Column index that is ignored by Set* methods (for optional columns)
+  static const uint32_t NO_COLUMN = 0xFFFFFFFF;
+
+  /// \brief Maximum number of columns in the schema
+  static const uint32_t MAX_COLUMNS = 16;
+
+  enum ColumnType
+    {
+      TIME = 1,    ///< \brief int64, nanoseconds (converted to seconds in TSV)
+      UINT8 = 2,
+      UINT32 = 3,
+      INT64 = 4,
+      FLOAT32 = 5,
+      FLOAT64 = 6
+    };
+
+  /**
+   * \brief Create writer
+   * \param os        output stream (has to be opened in binary mode)
+   * \param blockSize number of records in one block
+   */
+  V2vTraceWriter (boost::shared_ptr<std::ostream> os, uint32_t blockSize = 65536);
+
+  /**
+   * \brief Write the remaining records and labels (stops the writer thread, if any)
+   */
+  ~V2vTraceWriter ();
+
+  /**
+   * \brief Move packing and writing of the records to a separate thread
+   *
+   * Has to be called after the schema is complete.  The header is written immediately.
+   *
+   * \param queueSize maximum number of committed records that are not yet processed by the thread
+   */
+  void
+  StartBackgroundThread (uint32_t queueSize = 16384);
+
+  /**
+   * \brief Get number of records for which Commit had to wait until the writer thread freed space in the queue
+   */
+  uint64_t
+  GetStalls () const;
+
+  /**
+   * \brief Add column to the schema (has to be done before the first record)
+   * \returns index of the column
+   */
+  uint32_t
+  AddColumn (const std::string &name, ColumnType type);
+
+  void
+  AddLabel (uint32_t column, uint32_t value, const std::string &label);
+
+  bool
+  HasLabel (uint32_t column, uint32_t value) const;
+
+  void
+  SetTime (uint32_t column, const Time &time);
+
+  void
+  SetInteger (uint32_t column, int64_t value);
+
+  void
+  SetDouble (uint32_t column, double value);
+
+  /**
+   * \brief Append the record (columns that were not set are zero)
+   */
+  void
+  Commit ();
+
+  /**
+   * \brief Write buffered records (with the writer thread, only records that the thread has already processed)
+   */
+  void
+  Flush ();
+
+private:
+  void
+  WriteHeader ();
+
+  void
+  WriteBlock ();
+
+  /// \brief Loop of the writer thread
+  void
+  Run ();
+
+  template<class T>
+  void
+  Write (const T &value);
+
+private:
+  struct Column
+  {
+    std::string m_name;
+    ColumnType m_type;
+    std::vector<char> m_data;
+  };
+
+  union Value
+  {
+    int64_t m_integer;
+    double m_double;
+  };
+
+  struct Record
+  {
+    Value m_values[MAX_COLUMNS];
+  };
+
+  void
+  Append (const Record &record);
+
+  boost::shared_ptr<std::ostream> m_os;
+  uint32_t m_blockSize;
+  bool m_headerWritten;
+
+  std::vector<Column> m_columns;
+  Record m_record;
+  uint32_t m_records;
+
+  // writer thread
+  boost::shared_ptr< V2vTraceRingBuffer<Record> > m_queue;
+  boost::thread m_thread;
+  boost::mutex m_mutex; ///< \brief protects columns when Flush is called with the running thread
+  boost::condition_variable m_wakeup;
+  boost::atomic<bool> m_stopping;
+  uint64_t m_stalls;
+
+  typedef std::map<std::pair<uint32_t, uint32_t>, std::string> LabelMap;
+  LabelMap m_labels;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // V2V_TRACE_WRITER_H
@@ -20,14 +20,20 @@
  */
 
 #include "v2v-tracer.h"
+#include "v2v-packet-info-tag.h"
+#include "v2v-trace-stream.h"
+#include "v2v-broadcast-net-device.h"
+#include "ndn-v2v-net-device-face.h"
 #include "ns3/node.h"
 #include "ns3/packet.h"
-#include "ns3/config.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-phy.h"
 #include "ns3/callback.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/node-list.h"
 #include "ns3/names.h"
+#include "ns3/mobility-model.h"
 
 #include "ns3/ndn-l3-protocol.h"
 #include "ns3/ndn-content-store.h"
@@ -51,26 +57,35 @@ namespace ndn {
 
 
 boost::tuple< boost::shared_ptr<std::ostream>, std::list<boost::shared_ptr<V2vTracer> > >
-V2vTracer::InstallAll (const std::string &file)
+V2vTracer::InstallAll (const std::string &file, bool binary)
 {
   std::list<boost::shared_ptr<V2vTracer> > tracers;
-  boost::shared_ptr<std::ofstream> outputStream (new std::ofstream ());
-  outputStream->open (file.c_str (), std::ios_base::out | std::ios_base::trunc);
+  boost::shared_ptr<std::ostream> outputStream = V2vTraceStream::Open (file, binary);
 
-  if (!outputStream->is_open ())
+  if (!outputStream)
     return boost::make_tuple (outputStream, tracers);
 
+  boost::shared_ptr<V2vTraceWriter> writer;
+  if (binary)
+    {
+      writer = boost::make_shared<V2vTraceWriter> (outputStream);
+      CreateBinaryColumns (*writer);
+      writer->StartBackgroundThread ();
+    }
+
   for (NodeList::Iterator node = NodeList::Begin ();
        node != NodeList::End ();
        node++)
     {
       NS_LOG_DEBUG ("Node: " << lexical_cast<string> ((*node)->GetId ()));
 
-      boost::shared_ptr<V2vTracer> trace = make_shared<V2vTracer> (outputStream, *node);
+      boost::shared_ptr<V2vTracer> trace = binary ?
+        boost::make_shared<V2vTracer> (writer, *node) :
+        boost::make_shared<V2vTracer> (outputStream, *node);
       tracers.push_back (trace);
     }
 
-  if (tracers.size () > 0)
+  if (tracers.size () > 0 && !binary)
     {
       // *m_l3RateTrace << "# "; // not necessary for R's read.table
       tracers.front ()->PrintHeader (*outputStream);
@@ -88,7 +103,11 @@ V2vTracer::PrintHeader (std::ostream &os) const
      << "Node" << "\t"
 
      << "Event" << "\t"
-     << "SeqNo";
+     << "Uid" << "\t"
+     << "Type" << "\t"
+     << "Name" << "\t"
+     << "Size" << "\t"
+     << "X" << "\t" << "Y" << "\t" << "Z";
 }
 
 V2vTracer::V2vTracer (boost::shared_ptr<std::ostream> os, Ptr<Node> node)
@@ -106,6 +125,136 @@ V2vTracer::V2vTracer (boost::shared_ptr<std::ostream> os, Ptr<Node> node)
     }
 }
 
+V2vTracer::V2vTracer (boost::shared_ptr<V2vTraceWriter> writer, Ptr<Node> node)
+: m_nodePtr (node)
+, m_writer (writer)
+{
+  m_node = boost::lexical_cast<string> (m_nodePtr->GetId ());
+
+  Connect ();
+
+  string name = Names::FindName (node);
+  if (!name.empty ())
+    {
+      m_node = name;
+    }
+}
+
+void
+V2vTracer::CreateBinaryColumns (V2vTraceWriter &writer)
+{
+  // order has to match COLUMN_* constants
+  writer.AddColumn ("Time", V2vTraceWriter::TIME);
+  writer.AddColumn ("Node", V2vTraceWriter::UINT32);
+  writer.AddColumn ("Event", V2vTraceWriter::UINT8);
+  writer.AddColumn ("Uid", V2vTraceWriter::INT64);
+  writer.AddColumn ("Type", V2vTraceWriter::UINT8);
+  writer.AddColumn ("Name", V2vTraceWriter::UINT32);
+  writer.AddColumn ("Size", V2vTraceWriter::UINT32);
+  writer.AddColumn ("X", V2vTraceWriter::FLOAT32);
+  writer.AddColumn ("Y", V2vTraceWriter::FLOAT32);
+  writer.AddColumn ("Z", V2vTraceWriter::FLOAT32);
+
+  for (uint8_t event = DATA_CACHED; event <= CANCELING; event++)
+    {
+      writer.AddLabel (COLUMN_EVENT, event, GetEventName (event));
+    }
+  writer.AddLabel (COLUMN_TYPE, TYPE_INTEREST, GetTypeName (TYPE_INTEREST));
+  writer.AddLabel (COLUMN_TYPE, TYPE_DATA, GetTypeName (TYPE_DATA));
+}
+
+const char *
+V2vTracer::GetEventName (uint8_t event)
+{
+  switch (event)
+    {
+    case DATA_CACHED:
+      return "DataCached";
+    case INCOMING_INTEREST:
+      return "IncomingInterest";
+    case BROADCASTING:
+      return "Broadcasting";
+    case CANCELING:
+      return "Canceling";
+    default:
+      return "Unknown";
+    }
+}
+
+const char *
+V2vTracer::GetTypeName (uint8_t type)
+{
+  return type == TYPE_INTEREST ? "Interest" : "Data";
+}
+
+void
+V2vTracer::Write (uint8_t event, uint8_t type, uint32_t nameId, uint64_t uid, uint32_t size)
+{
+  if (m_mobility == 0)
+    {
+      m_mobility = m_nodePtr->GetObject<MobilityModel> ();
+    }
+  Vector pos = m_mobility != 0 ? m_mobility->GetPosition () : Vector ();
+
+  if (m_writer)
+    {
+      if (!m_writer->HasLabel (COLUMN_NAME, nameId))
+        {
+          m_writer->AddLabel (COLUMN_NAME, nameId, lexical_cast<string> (*V2vPacketInfoTag::GetInternedName (nameId)));
+        }
+
+      m_writer->SetTime (COLUMN_TIME, Simulator::Now ());
+      m_writer->SetInteger (COLUMN_NODE, m_nodePtr->GetId ());
+      m_writer->SetInteger (COLUMN_EVENT, event);
+      m_writer->SetInteger (COLUMN_UID, uid);
+      m_writer->SetInteger (COLUMN_TYPE, type);
+      m_writer->SetInteger (COLUMN_NAME, nameId);
+      m_writer->SetInteger (COLUMN_SIZE, size);
+      m_writer->SetDouble (COLUMN_X, pos.x);
+      m_writer->SetDouble (COLUMN_Y, pos.y);
+      m_writer->SetDouble (COLUMN_Z, pos.z);
+      m_writer->Commit ();
+      return;
+    }
+
+  *m_os << Simulator::Now ().ToDouble (Time::S) << "\t"
+        << m_node << "\t"
+        << GetEventName (event) << "\t"
+        << uid << "\t"
+        << GetTypeName (type) << "\t"
+        << *V2vPacketInfoTag::GetInternedName (nameId) << "\t"
+        << size << "\t"
+        << pos.x << "\t" << pos.y << "\t" << pos.z << "\n";
+}
+
+void
+V2vTracer::Write (uint8_t event, Ptr<const Packet> packet)
+{
+  // packet may already have link-layer headers, so it cannot be parsed, but the face tags all packets it sends
+  V2vPacketInfoTag tag;
+  if (packet->PeekPacketTag (tag))
+    {
+      Write (event,
+             tag.GetType () == HeaderHelper::INTEREST_NDNSIM ? TYPE_INTEREST : TYPE_DATA,
+             tag.GetNameId (), packet->GetUid (), packet->GetSize ());
+      return;
+    }
+
+  // aggregated frame: one record per aggregated packet, which is tagged with the byte tag (see V2vNetDeviceFace)
+  ByteTagIterator i = packet->GetByteTagIterator ();
+  while (i.HasNext ())
+    {
+      ByteTagIterator::Item item = i.Next ();
+      if (item.GetTypeId () != V2vPacketInfoTag::GetTypeId ())
+        continue;
+
+      item.GetTag (tag);
+      Write (event,
+             tag.GetType () == HeaderHelper::INTEREST_NDNSIM ? TYPE_INTEREST : TYPE_DATA,
+             tag.GetNameId (), packet->GetUid (), item.GetEnd () - item.GetStart ());
+    }
+}
+
 void
 V2vTracer::Connect ()
 {
@@ -117,40 +266,56 @@ V2vTracer::Connect ()
   Ptr<L3Protocol> ndn = m_nodePtr->GetObject<L3Protocol> ();
   for (uint32_t faceId = 0; faceId < ndn->GetNFaces (); faceId++)
     {
-      ndn->GetFace (faceId)->TraceConnectWithoutContext ("Canceling", MakeCallback (&V2vTracer::Canceling, this));
+      Ptr<V2vNetDeviceFace> face = DynamicCast<V2vNetDeviceFace> (ndn->GetFace (faceId));
+      if (face == 0)
+        continue;
+
+      face->TraceConnectWithoutContext ("CancelingData", MakeCallback (&V2vTracer::Canceling, this));
     }
 
-  Config::ConnectWithoutContext ("/NodeList/"+m_node+"/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyTxBegin", MakeCallback (&V2vTracer::PhyOutData, this));
+  // connect directly to the devices of the node, instead of matching the config path for every node
+  for (uint32_t deviceId = 0; deviceId < m_nodePtr->GetNDevices (); deviceId++)
+    {
+      Ptr<NetDevice> device = m_nodePtr->GetDevice (deviceId);
+
+      Ptr<WifiNetDevice> wifi = DynamicCast<WifiNetDevice> (device);
+      if (wifi != 0)
+        {
+          wifi->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&V2vTracer::PhyOutData, this));
+          continue;
+        }
+
+      Ptr<V2vBroadcastNetDevice> broadcast = DynamicCast<V2vBroadcastNetDevice> (device);
+      if (broadcast != 0)
+        {
+          broadcast->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&V2vTracer::PhyOutData, this));
+        }
+    }
 }
 
 void
 V2vTracer::DidAddEntry (Ptr<const cs::Entry> csEntry)
 {
-  *m_os << Simulator::Now ().ToDouble (Time::S) << "\t"
-       << m_node << "\t" << "DataCached" << "\t" << csEntry->GetName ().GetLastComponent () << "\n";
+  Write (DATA_CACHED, TYPE_DATA, V2vPacketInfoTag::InternName (csEntry->GetName ()), 0, 0);
 }
 
 
 void
 V2vTracer::InInterest (Ptr<const Interest> header, Ptr<const Face> face)
 {
-  *m_os << Simulator::Now ().ToDouble (Time::S) << "\t"
-       << m_node << "\t" << "Incoming interest" << "\t" << header->GetName ().GetLastComponent () << "\n";
+  Write (INCOMING_INTEREST, TYPE_INTEREST, V2vPacketInfoTag::InternName (header->GetName ()), 0, 0);
 }
 
 void
 V2vTracer::PhyOutData (Ptr<const Packet> packet)
 {
-  *m_os << Simulator::Now ().ToDouble (Time::S) << "\t"
-       << m_node << "\t" << "Broadcasting" << "\t" << *packet/*->PeekPacketTag<CcnxNameComponentsTag> ()->GetName ()->GetLastComponent ()*/ << "\n";
+  Write (BROADCASTING, packet);
 }
 
 void
 V2vTracer::Canceling (Ptr<Node> node, Ptr<const Packet> packet)
 {
-  // NS_LOG_INFO( "Dropping packet due to noise or error model calculation." );
-  *m_os << Simulator::Now ().ToDouble (Time::S) << "\t"
-       << m_node << "\t" << "Canceling transmission" << "\t" << *packet/*->PeekPacketTag<CcnxNameComponentsTag> ()->GetName ()->GetLastComponent ()*/ << "\n";
+  Write (CANCELING, packet);
 }
 
 } // namespace ndn
@@ -29,6 +29,9 @@
 #include <ns3/ndn-face.h>
 #include <ns3/packet.h>
 #include <ns3/node.h>
+#include <ns3/mobility-model.h>
+
+#include "v2v-trace-writer.h"
 
 namespace ns3 {
 namespace ndn {
@@ -40,13 +43,15 @@ public:
    * @brief Helper method to install tracers on all simulation nodes
    *
    * @param file File to which traces will be written
+   * @param binary write binary columnar trace (see V2vTraceWriter) instead of text; binary records are
+   *               packed and written by a separate thread
    *
    * @returns a tuple of reference to output stream and list of tracers. !!! Attention !!! This tuple needs to be preserved
    *          for the lifetime of simulation, otherwise SEGFAULTs are inevitable
    *
    */
   static boost::tuple< boost::shared_ptr<std::ostream>, std::list<boost::shared_ptr<V2vTracer> > >
-  InstallAll (const std::string &file);
+  InstallAll (const std::string &file, bool binary = false);
 
   /**
    * @brief Trace constructor that attaches to the node using node pointer
@@ -55,6 +60,19 @@ public:
    */
   V2vTracer (boost::shared_ptr<std::ostream> os, Ptr<Node> node);
 
+  /**
+   * @brief Trace constructor for binary output
+   * @param writer  binary trace writer with the schema created by CreateBinaryColumns
+   * @param node    pointer to the node
+   */
+  V2vTracer (boost::shared_ptr<V2vTraceWriter> writer, Ptr<Node> node);
+
+  /**
+   * @brief Create schema of the binary trace
+   */
+  static void
+  CreateBinaryColumns (V2vTraceWriter &writer);
+
   /**
    * @brief Connect traces on a node
    */
@@ -74,11 +92,58 @@ private:
 
   void Canceling (Ptr<Node> node, Ptr<const Packet> packet);
 
+  /**
+   * @brief Write event record
+   * @param uid  UID of the packet (0 if event is not related to a particular packet)
+   * @param size size of the packet (0 if event is not related to a particular packet)
+   */
+  void
+  Write (uint8_t event, uint8_t type, uint32_t nameId, uint64_t uid, uint32_t size);
+
+  void
+  Write (uint8_t event, Ptr<const Packet> packet);
+
+  static const char *
+  GetEventName (uint8_t event);
+
+  static const char *
+  GetTypeName (uint8_t type);
+
+  enum
+    {
+      DATA_CACHED = 1,
+      INCOMING_INTEREST = 2,
+      BROADCASTING = 3,
+      CANCELING = 4
+    };
+
+  enum
+    {
+      TYPE_INTEREST = 1,
+      TYPE_DATA = 2
+    };
+
+  enum
+    {
+      COLUMN_TIME = 0,
+      COLUMN_NODE = 1,
+      COLUMN_EVENT = 2,
+      COLUMN_UID = 3,
+      COLUMN_TYPE = 4,
+      COLUMN_NAME = 5,
+      COLUMN_SIZE = 6,
+      COLUMN_X = 7,
+      COLUMN_Y = 8,
+      COLUMN_Z = 9
+    };
+
 private:
   std::string m_node;
   Ptr<Node> m_nodePtr;
+  Ptr<MobilityModel> m_mobility;
 
   boost::shared_ptr<std::ostream> m_os;
+  boost::shared_ptr<V2vTraceWriter> m_writer;
 };
 
 } // namespace ndn
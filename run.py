@@ -4,10 +4,14 @@
 from subprocess import call
 from sys import argv
 import os
+import glob
 import subprocess
 import workerpool
 import multiprocessing
 import argparse
+import shutil
+import gzip
+import bz2
 
 ######################################################################
 ######################################################################
@@ -26,6 +30,12 @@ parser.add_argument('-s', '--simulate', dest="simulate", action='store_true', de
 parser.add_argument('-g', '--no-graph', dest="graph", action='store_false', default=True,
                     help='Do not build a graph for the scenario (builds a graph by default)')
 
+parser.add_argument('--summary', dest="summary", action='store_true', default=False,
+                    help='Aggregate traces during simulation and keep only per-run summaries (car-relay --summary)')
+
+parser.add_argument('--codec', dest="codec", choices=["gzip", "bzip2"], default=None,
+                    help='Compress traces during simulation (V2vTraceCodec) instead of compressing the merged results (text traces only)')
+
 args = parser.parse_args()
 
 if not args.list and len(args.scenarios)==0:
@@ -56,6 +66,73 @@ class SimulationJob (workerpool.Job):
 
 pool = workerpool.WorkerPool(size = multiprocessing.cpu_count())
 
+def convert_binary_traces (path):
+    "Convert binary traces (<path>.v2vt, including per-rank files) to text"
+    base = path[:-len(".txt")]
+    for binary in glob.glob ("%s.v2vt*" % base):
+        subprocess.call (["./v2v-trace-to-tsv.py", binary, base + ".txt" + binary[len(base + ".v2vt"):]])
+        os.remove (binary)
+
+def trace_opener (path):
+    "Get function to open the text trace, compression (see V2vTraceCodec) is selected by the extension"
+    if path.endswith (".gz"):
+        return gzip.open
+    elif path.endswith (".bz2"):
+        return bz2.BZ2File
+    else:
+        return open
+
+def merge_rank_files (path, header = True):
+    "Merge outputs of the distributed (MPI) simulation, written by each rank into <path>.rank-N"
+    parts = sorted (glob.glob ("%s.rank-*" % path))
+    if len (parts) == 0:
+        return
+
+    opener = trace_opener (path)
+    firstline = ""
+    records = []
+    for part in parts:
+        f_in = opener (part, "rb")
+        if header:
+            firstline = f_in.readline ()
+        records.extend (f_in.readlines ())
+        f_in.close ()
+        os.remove (part)
+
+    records.sort (key = lambda line: float (line.split ("\t", 1)[0]))
+
+    if "histogram.txt" in path:
+        # histograms of the ranks are summed up (constant columns, if any, are the same for all ranks)
+        totals = {}
+        rest = {}
+        for line in records:
+            fields = line.rstrip ("\n").split ("\t")
+            key = float (fields[0])
+            totals[key] = totals.get (key, 0) + int (fields[1])
+            rest[key] = "".join (["\t" + field for field in fields[2:]])
+        records = ["%g\t%d%s\n" % (key, totals[key], rest[key]) for key in sorted (totals.keys ())]
+
+    if "jump-distance.txt" in path:
+        # tracer logs only when the reception advances the propagation front of the data item in its
+        # direction (see V2vPropagationFront), each rank tracked the fronts of its own cars.  Fronts are
+        # measured from the data source in all ranks, so the same rule is applied to the merged records.
+        # Columns are Time, NodeId, JumpDistance, Item, Front, followed by constant columns, if any
+        fronts = {}
+        filtered = []
+        for line in records:
+            fields = line.rstrip ("\n").split ("\t")
+            front = float (fields[4])
+            key = (fields[3], front >= 0)
+            if abs (front) > fronts.get (key, 0):
+                fronts[key] = abs (front)
+                filtered.append (line)
+        records = filtered
+
+    f_out = opener (path, "wb")
+    f_out.write (firstline)
+    f_out.writelines (records)
+    f_out.close ()
+
 class Processor:
     def run (self):
         if args.list:
@@ -76,9 +153,17 @@ class Processor:
                 self.graph ()
 
 class CarRelay (Processor):
-    def __init__ (self, name, extra=[], runs = range(1,11), distances = range (10, 180, 40)):
+    def __init__ (self, name, extra=[], runs = range(1,11), distances = range (10, 180, 40), ranks = 1, binary = False, summary = None, codec = None):
         self.name = name
         self.extra = extra
+        self.ranks = ranks
+        self.binary = binary
+        self.summary = summary if summary is not None else args.summary
+        self.codec = codec if codec is not None else args.codec
+        if self.binary and self.codec and not self.summary:
+            # binary traces are not compressed (V2vTraceCodec applies to text traces only), so there is
+            # nothing to concatenate with the codec
+            raise ValueError ("%s: binary traces cannot be combined with --codec" % name)
         self.runs = runs
         self.distances = distances
 
@@ -90,6 +175,22 @@ class CarRelay (Processor):
                            "--distance=%d" % distance,
                            ] + self.extra
 
+                if self.binary:
+                    cmdline.append ("--binaryTraces")
+
+                if self.summary:
+                    cmdline.append ("--summary")
+
+                if self.codec:
+                    # run parameters are written into the traces, only the first trace has the header
+                    first = (distance == self.distances[0] and run == self.runs[0])
+                    cmdline += ["--V2vTraceCodec=%s" % self.codec,
+                                "--V2vTraceColumns=Run=%d,Distance=%d" % (run, distance),
+                                "--V2vTraceHeader=%d" % first]
+
+                if self.ranks > 1:
+                    cmdline = ["mpirun", "-np", "%d" % self.ranks] + cmdline + ["--mpi=1", "--lightweight"]
+
                 job = SimulationJob (cmdline)
                 pool.put (job)
 
@@ -102,11 +203,19 @@ class CarRelay (Processor):
         prefix_out = "results/%s/car-relay" % self.name;
         prefix_in = "results/car-relay";
         subtypes = ["jump-distance", "distance", "in-cache", "tx"]
+        if self.summary:
+            subtypes = ["jump-distance", "in-cache", "tx-counts", "tx-histogram", "jump-distance-histogram"]
+        if self.codec:
+            self.concatenate (prefix_in, prefix_out, subtypes)
+            return
+
         for subtype in subtypes:
             needHeader = True
             f_out = open ("%s-%s.txt" % (prefix_out, subtype), "w")
             for distance in self.distances:
                 for run in self.runs:
+                    convert_binary_traces ("%s-%d-%d-%s.txt" % (prefix_in, run, distance, subtype))
+                    merge_rank_files ("%s-%d-%d-%s.txt" % (prefix_in, run, distance, subtype))
                     f_in = open ("%s-%d-%d-%s.txt" % (prefix_in, run, distance, subtype), "r")
                     firstline = f_in.readline ()
 
@@ -122,6 +231,24 @@ class CarRelay (Processor):
             f_out.close ()
             subprocess.call ("bzip2 -f \"%s-%s.txt\"" % (prefix_out, subtype), shell=True)
 
+    def concatenate (self, prefix_in, prefix_out, subtypes):
+        "Merge compressed traces that already have Run and Distance columns"
+        extension = {"gzip": ".gz", "bzip2": ".bz2"}[self.codec]
+        for subtype in subtypes:
+            f_out = open ("%s-%s.txt%s" % (prefix_out, subtype, extension), "wb")
+            header = True
+            for distance in self.distances:
+                for run in self.runs:
+                    path = "%s-%d-%d-%s.txt%s" % (prefix_in, run, distance, subtype, extension)
+                    merge_rank_files (path, header)
+                    header = False
+
+                    f_in = open (path, "rb")
+                    shutil.copyfileobj (f_in, f_out)
+                    f_in.close ()
+                    os.remove (path)
+            f_out.close ()
+
     def graph (self):
         subprocess.call ("./graphs/%s.R" % self.name, shell=True)
 
@@ -138,6 +265,10 @@ try:
     fig5 = CarRelay (name="figure-5-retx-count", runs = range(1,11), distances = range (10, 180, 40))
     fig5.run ()
 
+    # Same as Figure 5, but data is pushed only away from the producer (compared with Figure 5 on the graph)
+    fig5d = CarRelay (name="figure-5-retx-count-directional", extra = ["--directional"], runs = range(1,11), distances = range (10, 180, 40))
+    fig5d.run ()
+
 finally:
     pool.join ()
     pool.shutdown ()
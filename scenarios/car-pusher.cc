@@ -33,6 +33,10 @@
 
 #include "ndn-v2v-net-device-face.h"
 #include "v2v-tracer.h"
+#include "v2v-trace-stream.h"
+#include "v2v-face-stats.h"
+#include "v2v-broadcast-helper.h"
+#include "v2v-broadcast-net-device.h"
 
 using namespace ns3;
 using namespace boost;
@@ -83,6 +87,22 @@ main (int argc, char *argv[])
   double fixedDistance = -1;
   cmd.AddValue ("fixedDistance", "Length of the highway. Number of cars will be set as (fixedDistance / distance + 1). If not set, there are 1000 cars", fixedDistance);
 
+  bool stats = false;
+  cmd.AddValue ("stats", "Dump per-face queueing statistics at the end of the run", stats);
+
+  bool cutoff = false;
+  cmd.AddValue ("cutoff", "Do not evaluate propagation loss for cars beyond the reception cutoff distance "
+                "(saves loss calculations only, every transmission still reaches all devices of the channel; see --lightweight)", cutoff);
+
+  bool tabulated = false;
+  cmd.AddValue ("tabulated", "Evaluate propagation loss using precomputed tables", tabulated);
+
+  bool lightweight = false;
+  cmd.AddValue ("lightweight", "Use lightweight disk-range broadcast devices instead of 802.11a (for fast parameter screening)", lightweight);
+
+  bool binaryTraces = false;
+  cmd.AddValue ("binaryTraces", "Write traces in binary columnar format (convert to text with v2v-trace-to-tsv.py)", binaryTraces);
+
   cmd.Parse (argc,argv);
 
   uint32_t numberOfCars = 1000;
@@ -104,8 +124,21 @@ main (int argc, char *argv[])
 
   YansWifiChannelHelper wifiChannel;// = YansWifiChannelHelper::Default ();
   wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
-  wifiChannel.AddPropagationLoss ("ns3::ThreeLogDistancePropagationLossModel");
-  wifiChannel.AddPropagationLoss ("ns3::NakagamiPropagationLossModel");
+  if (cutoff)
+    {
+      // the same ThreeLogDistance + Nakagami chain, evaluated only within the cutoff distance
+      wifiChannel.AddPropagationLoss ("ns3::ndn::V2vCutoffPropagationLossModel",
+                                      "Tabulated", BooleanValue (tabulated));
+    }
+  else if (tabulated)
+    {
+      wifiChannel.AddPropagationLoss ("ns3::ndn::V2vTabulatedPropagationLossModel");
+    }
+  else
+    {
+      wifiChannel.AddPropagationLoss ("ns3::ThreeLogDistancePropagationLossModel");
+      wifiChannel.AddPropagationLoss ("ns3::NakagamiPropagationLossModel");
+    }
 
   //YansWifiPhy wifiPhy = YansWifiPhy::Default();
   YansWifiPhyHelper wifiPhyHelper = YansWifiPhyHelper::Default ();
@@ -136,12 +169,22 @@ main (int argc, char *argv[])
   mobility.Install (nodes);
 
   // 2. Install Wifi
-  NetDeviceContainer wifiNetDevices = wifi.Install (wifiPhyHelper, wifiMac, nodes);
+  NetDeviceContainer wifiNetDevices;
+  if (lightweight)
+    {
+      ndn::V2vBroadcastHelper broadcastHelper;
+      wifiNetDevices = broadcastHelper.Install (nodes);
+    }
+  else
+    {
+      wifiNetDevices = wifi.Install (wifiPhyHelper, wifiMac, nodes);
+    }
 
   // 3. Install NDN stack
   NS_LOG_INFO ("Installing NDN stack");
   ndn::StackHelper ndnHelper;
   ndnHelper.AddNetDeviceFaceCreateCallback (WifiNetDevice::GetTypeId (), MakeCallback (V2vNetDeviceFaceCallback));
+  ndnHelper.AddNetDeviceFaceCreateCallback (ndn::V2vBroadcastNetDevice::GetTypeId (), MakeCallback (V2vNetDeviceFaceCallback));
   ndnHelper.SetForwardingStrategy ("ns3::ndn::fw::V2v");
   ndnHelper.SetContentStore ("ns3::ndn::cs::Lru",
                              "MaxSize", "10000");
@@ -165,7 +208,7 @@ main (int argc, char *argv[])
   consumerHelper.Install (nodes.Get (0));
 
   boost::tuple< boost::shared_ptr<std::ostream>, std::list<boost::shared_ptr<ndn::V2vTracer> > >
-    tracing = ndn::V2vTracer::InstallAll ("results/car-pusher.txt");
+    tracing = ndn::V2vTracer::InstallAll ("results/car-pusher" + ndn::V2vTraceStream::GetExtension (binaryTraces), binaryTraces);
 
   Simulator::Stop (Seconds (300.0));
 
@@ -175,6 +218,12 @@ main (int argc, char *argv[])
 
   NS_LOG_INFO ("Done");
 
+  if (stats)
+    {
+      string prefix = "results/car-pusher-" + lexical_cast<string> (run) + "-" + lexical_cast<string> (distance) + "-";
+      ndn::V2vFaceStats::DumpAll (prefix+"stats.txt");
+    }
+
   Simulator::Destroy ();
 
   return 0;
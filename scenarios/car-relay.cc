@@ -29,6 +29,14 @@
 
 #include "ndn-v2v-net-device-face.h"
 #include "car-relay-tracer.h"
+#include "v2v-face-stats.h"
+#include "v2v-broadcast-helper.h"
+#include "v2v-broadcast-net-device.h"
+#include "v2v-highway-partition.h"
+
+#ifdef HAVE_NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif
 
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
@@ -71,7 +79,7 @@ main (int argc, char *argv[])
   // Config::SetDefault ("ns3::CcnxBroadcastNetDeviceFace::MaxRetransmissionAttempts", StringValue ("2"));
 
   // !!! very important parameter !!!
-  // Should keep PIT entry to prevent duplicate interests from re-propagating
+  // Should keep PIT entry to prevent duplicate interests from re-propagating (unless --duplicateFilter is used)
   Config::SetDefault ("ns3::ndn::Pit::PitEntryPruningTimout", StringValue ("10s"));
 
   CommandLine cmd;
@@ -90,8 +98,76 @@ main (int argc, char *argv[])
   double fixedDistance = -1;
   cmd.AddValue ("fixedDistance", "Length of the highway. Number of cars will be set as (fixedDistance / distance + 1). If not set, there are 1000 cars", fixedDistance);
 
+  bool stats = false;
+  cmd.AddValue ("stats", "Dump per-face queueing statistics at the end of the run", stats);
+
+  bool cutoff = false;
+  cmd.AddValue ("cutoff", "Do not evaluate propagation loss for cars beyond the reception cutoff distance "
+                "(saves loss calculations only, every transmission still reaches all devices of the channel; see --lightweight)", cutoff);
+
+  bool tabulated = false;
+  cmd.AddValue ("tabulated", "Evaluate propagation loss using precomputed tables", tabulated);
+
+  bool lightweight = false;
+  cmd.AddValue ("lightweight", "Use lightweight disk-range broadcast devices instead of 802.11a (for fast parameter screening)", lightweight);
+
+  bool summary = false;
+  cmd.AddValue ("summary", "Aggregate traces during simulation and write only per-run summaries (tx counts, propagation front, jump distance histogram, cache arrivals)", summary);
+
+  bool binaryTraces = false;
+  cmd.AddValue ("binaryTraces", "Write traces in binary columnar format (convert to text with v2v-trace-to-tsv.py)", binaryTraces);
+
+  bool mpi = false;
+  cmd.AddValue ("mpi", "Distribute simulation over MPI ranks, each simulating a contiguous highway segment (requires --lightweight)", mpi);
+
+  double scope = 0;
+  cmd.AddValue ("scope", "Radius of the geographic scope of the generated data around the producer (0 = unlimited)", scope);
+
+  bool directional = false;
+  cmd.AddValue ("directional", "Push data only along the highway, away from the producer (cars behind the previous hop do not re-broadcast)", directional);
+
+  string suppression = "distance";
+  cmd.AddValue ("suppression", "Policy to cancel queued transmissions of overheard names: distance, counter, or coverage "
+                "(parameters can be set with --ns3::ndn::V2vCounterSuppressionPolicy::Threshold and alike)", suppression);
+
+  bool duplicateFilter = false;
+  cmd.AddValue ("duplicateFilter", "Drop duplicate Interests using the strategy's duplicate filter instead of long-living PIT entries "
+                "(PIT entries are pruned after 1s)", duplicateFilter);
+
   cmd.Parse (argc,argv);
 
+  if (duplicateFilter)
+    {
+      Config::SetDefault ("ns3::ndn::fw::V2v::DuplicateFilterLifetime", StringValue ("10s"));
+      Config::SetDefault ("ns3::ndn::Pit::PitEntryPruningTimout", StringValue ("1s"));
+    }
+
+  if (suppression == "counter")
+    Config::SetDefault ("ns3::ndn::V2vNetDeviceFace::SuppressionPolicy", StringValue ("ns3::ndn::V2vCounterSuppressionPolicy"));
+  else if (suppression == "coverage")
+    Config::SetDefault ("ns3::ndn::V2vNetDeviceFace::SuppressionPolicy", StringValue ("ns3::ndn::V2vCoverageSuppressionPolicy"));
+  else
+    NS_ABORT_MSG_IF (suppression != "distance", "Unknown suppression policy " << suppression);
+
+  Config::SetDefault ("ns3::ndn::fw::V2v::ScopeRadius", DoubleValue (scope));
+  if (directional)
+    {
+      // producer is the first car of the highway (see HighwayPositionAllocator below)
+      Config::SetDefault ("ns3::ndn::fw::V2v::PropagationHeading", VectorValue (Vector (1.0, 0.0, 0.0)));
+    }
+
+  if (mpi)
+    {
+#ifdef HAVE_NS3_MPI
+      NS_ABORT_MSG_IF (!lightweight, "MPI mode requires --lightweight, only V2vBroadcastChannel supports distributed simulation");
+
+      GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DistributedSimulatorImpl"));
+      MpiInterface::Enable (&argc, &argv);
+#else
+      NS_FATAL_ERROR ("NS-3 has been compiled without MPI support");
+#endif
+    }
+
   uint32_t numberOfCars = 1000;
   if (fixedDistance > 0)
     {
@@ -113,8 +189,21 @@ main (int argc, char *argv[])
 
   YansWifiChannelHelper wifiChannel;// = YansWifiChannelHelper::Default ();
   wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
-  wifiChannel.AddPropagationLoss ("ns3::ThreeLogDistancePropagationLossModel");
-  wifiChannel.AddPropagationLoss ("ns3::NakagamiPropagationLossModel");
+  if (cutoff)
+    {
+      // the same ThreeLogDistance + Nakagami chain, evaluated only within the cutoff distance
+      wifiChannel.AddPropagationLoss ("ns3::ndn::V2vCutoffPropagationLossModel",
+                                      "Tabulated", BooleanValue (tabulated));
+    }
+  else if (tabulated)
+    {
+      wifiChannel.AddPropagationLoss ("ns3::ndn::V2vTabulatedPropagationLossModel");
+    }
+  else
+    {
+      wifiChannel.AddPropagationLoss ("ns3::ThreeLogDistancePropagationLossModel");
+      wifiChannel.AddPropagationLoss ("ns3::NakagamiPropagationLossModel");
+    }
 
   //YansWifiPhy wifiPhy = YansWifiPhy::Default();
   YansWifiPhyHelper wifiPhyHelper = YansWifiPhyHelper::Default ();
@@ -137,12 +226,20 @@ main (int argc, char *argv[])
   mobility.SetMobilityModel("ns3::CustomConstantVelocityMobilityModel",
                             "ConstantVelocity", VectorValue(Vector(26.8224, 0, 0)));
 
-  NodeContainer nodes;
-  nodes.Create (numberOfCars);
+  NodeContainer nodes = ndn::V2vHighwayPartition::Create (numberOfCars);
 
   ////////////////
   // 1. Install Wifi
-  NetDeviceContainer wifiNetDevices = wifi.Install (wifiPhyHelper, wifiMacHelper, nodes);
+  NetDeviceContainer wifiNetDevices;
+  if (lightweight)
+    {
+      ndn::V2vBroadcastHelper broadcastHelper;
+      wifiNetDevices = broadcastHelper.Install (nodes);
+    }
+  else
+    {
+      wifiNetDevices = wifi.Install (wifiPhyHelper, wifiMacHelper, nodes);
+    }
 
   // 2. Install Mobility model
   mobility.Install (nodes);
@@ -151,12 +248,15 @@ main (int argc, char *argv[])
   NS_LOG_INFO ("Installing NDN stack");
   ndn::StackHelper ndnHelper;
   ndnHelper.AddNetDeviceFaceCreateCallback (WifiNetDevice::GetTypeId (), MakeCallback (V2vNetDeviceFaceCallback));
+  ndnHelper.AddNetDeviceFaceCreateCallback (ndn::V2vBroadcastNetDevice::GetTypeId (), MakeCallback (V2vNetDeviceFaceCallback));
   ndnHelper.SetForwardingStrategy ("ns3::ndn::fw::V2v");
   ndnHelper.SetContentStore ("ns3::ndn::cs::Lru",
                              "MaxSize", "10000");
   ndnHelper.SetDefaultRoutes (true);
   ndnHelper.Install (nodes);
 
+  ndn::V2vHighwayPartition::InstallLookahead (nodes);
+
   // 4. Set up applications
   NS_LOG_INFO ("Installing Applications");
 
@@ -171,29 +271,54 @@ main (int argc, char *argv[])
   // install producer and consumer on the same node
   NS_LOG_INFO("Making node("<< nodes.Get(0)->GetId() <<") both a consumer and producer. "<<
 	      "It will pull data from it self and then data will be propagated out.");
-  consumerHelper.Install (nodes.Get (0));
-  producerHelper.Install (nodes.Get (0));
+  if (ndn::V2vHighwayPartition::IsLocal (nodes.Get (0)))
+    {
+      consumerHelper.Install (nodes.Get (0));
+      producerHelper.Install (nodes.Get (0));
+    }
 
   ////////////////
 
   string prefix = "results/car-relay-" + lexical_cast<string> (run) + "-" + lexical_cast<string> (distance) + "-";
+  // in MPI mode, every rank writes its own files, which are merged by run.py
+  string suffix = ndn::V2vHighwayPartition::GetFileSuffix ();
+  boost::tuple< boost::shared_ptr<ndn::CarRelayTracer::Sinks>, std::list<boost::shared_ptr<ndn::CarRelayTracer> > > tracing;
+  boost::tuple< boost::shared_ptr<ndn::CarRelayTracer::Summary>, std::list<boost::shared_ptr<ndn::CarRelayTracer> > > summaryTracing;
 
-  boost::tuple< boost::shared_ptr<std::ostream>, std::list<boost::shared_ptr<ndn::CarRelayTracer> > >
-    tracing1 = ndn::CarRelayTracer::InstallAll (prefix+"distance.txt", ndn::CarRelayTracer::DISTANCE_WAITING);
+  if (summary)
+    {
+      summaryTracing = ndn::CarRelayTracer::InstallSummary (prefix, suffix);
+    }
+  else
+    {
+      tracing = ndn::CarRelayTracer::InstallAll (prefix, suffix,
+                                                 ndn::CarRelayTracer::DISTANCE_WAITING | ndn::CarRelayTracer::JUMP_DISTANCE |
+                                                 ndn::CarRelayTracer::TX | ndn::CarRelayTracer::IN_CACHE,
+                                                 binaryTraces);
+    }
 
-  boost::tuple< boost::shared_ptr<std::ostream>, std::list<boost::shared_ptr<ndn::CarRelayTracer> > >
-    tracing2 = ndn::CarRelayTracer::InstallAll (prefix+"jump-distance.txt", ndn::CarRelayTracer::JUMP_DISTANCE);
+  Simulator::Stop (Seconds (30.0));
 
-  boost::tuple< boost::shared_ptr<std::ostream>, std::list<boost::shared_ptr<ndn::CarRelayTracer> > >
-    tracing3 = ndn::CarRelayTracer::InstallAll (prefix+"tx.txt", ndn::CarRelayTracer::TX);
+  Simulator::Run ();
 
-  boost::tuple< boost::shared_ptr<std::ostream>, std::list<boost::shared_ptr<ndn::CarRelayTracer> > >
-    tracing4 = ndn::CarRelayTracer::InstallAll (prefix+"in-cache.txt", ndn::CarRelayTracer::IN_CACHE);
+  if (summary)
+    {
+      summaryTracing.get<0> ()->Write ();
+    }
 
-  Simulator::Stop (Seconds (30.0));
+  if (stats)
+    {
+      ndn::V2vFaceStats::DumpAll (prefix+"stats.txt"+suffix);
+    }
 
-  Simulator::Run ();
   Simulator::Destroy ();
 
+#ifdef HAVE_NS3_MPI
+  if (mpi)
+    {
+      MpiInterface::Disable ();
+    }
+#endif
+
   return 0;
 }
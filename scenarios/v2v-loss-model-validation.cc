@@ -0,0 +1,150 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2012-2013 University of California, Los Angeles
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Alexander Afanasyev <alexander.afanasyev@ucla.edu>
+ */
+
+// Validation of V2vTabulatedPropagationLossModel against ThreeLogDistance + Nakagami chain.
+//
+// For a set of distances, draws received power samples from both models and reports the
+// difference of the means and the Kolmogorov-Smirnov distance between the sample
+// distributions, as well as the time spent in both models.  Exits with non-zero status if
+// any of the values is out of tolerance.
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+
+#include "v2v-tabulated-propagation-loss-model.h"
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+
+using namespace ns3;
+
+static double
+GetKsDistance (std::vector<double> &a, std::vector<double> &b)
+{
+  std::sort (a.begin (), a.end ());
+  std::sort (b.begin (), b.end ());
+
+  double distance = 0;
+  size_t i = 0, j = 0;
+  while (i < a.size () && j < b.size ())
+    {
+      if (a[i] <= b[j])
+        i++;
+      else
+        j++;
+
+      distance = std::max (distance, std::fabs (static_cast<double> (i) / a.size () - static_cast<double> (j) / b.size ()));
+    }
+  return distance;
+}
+
+static double
+GetMean (const std::vector<double> &values)
+{
+  double sum = 0;
+  for (std::vector<double>::const_iterator i = values.begin (); i != values.end (); i++)
+    sum += *i;
+  return sum / values.size ();
+}
+
+static double
+GetVariance (const std::vector<double> &values, double mean)
+{
+  double sum = 0;
+  for (std::vector<double>::const_iterator i = values.begin (); i != values.end (); i++)
+    sum += (*i - mean) * (*i - mean);
+  return sum / (values.size () - 1);
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t samples = 20000;
+  double maxDistance = 1000.0;
+  double distanceStep = 10.0;
+  double meanTolerance = 4.0;
+  double ksTolerance = 0.03;
+
+  CommandLine cmd;
+  cmd.AddValue ("samples", "Number of samples per distance", samples);
+  cmd.AddValue ("maxDistance", "Maximum distance to check", maxDistance);
+  cmd.AddValue ("distanceStep", "Step between checked distances", distanceStep);
+  cmd.AddValue ("meanTolerance", "Maximum allowed difference of mean received power (in standard errors of the difference)", meanTolerance);
+  cmd.AddValue ("ksTolerance", "Maximum allowed Kolmogorov-Smirnov distance", ksTolerance);
+  cmd.Parse (argc, argv);
+
+  Ptr<PropagationLossModel> original = CreateObject<ThreeLogDistancePropagationLossModel> ();
+  original->SetNext (CreateObject<NakagamiPropagationLossModel> ());
+
+  Ptr<PropagationLossModel> tabulated = CreateObject<ndn::V2vTabulatedPropagationLossModel> ();
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+
+  const double txPower = 16.0206; // default YansWifiPhy tx power
+  std::vector<double> originalRx (samples);
+  std::vector<double> tabulatedRx (samples);
+
+  clock_t originalTime = 0;
+  clock_t tabulatedTime = 0;
+  bool ok = true;
+
+  std::cout << "Distance\tMeanOriginal\tMeanTabulated\tMeanDiff\tKS\n";
+  for (double distance = distanceStep; distance <= maxDistance; distance += distanceStep)
+    {
+      b->SetPosition (Vector (distance, 0, 0));
+
+      clock_t start = clock ();
+      for (uint32_t i = 0; i < samples; i++)
+        originalRx[i] = original->CalcRxPower (txPower, a, b);
+      originalTime += clock () - start;
+
+      start = clock ();
+      for (uint32_t i = 0; i < samples; i++)
+        tabulatedRx[i] = tabulated->CalcRxPower (txPower, a, b);
+      tabulatedTime += clock () - start;
+
+      double originalMean = GetMean (originalRx);
+      double tabulatedMean = GetMean (tabulatedRx);
+      double standardError = std::sqrt ((GetVariance (originalRx, originalMean) +
+                                         GetVariance (tabulatedRx, tabulatedMean)) / samples);
+      double ks = GetKsDistance (originalRx, tabulatedRx);
+
+      bool pass = std::fabs (originalMean - tabulatedMean) <= meanTolerance * standardError && ks <= ksTolerance;
+      ok = ok && pass;
+
+      std::cout << distance << "\t"
+                << originalMean << "\t"
+                << tabulatedMean << "\t"
+                << (tabulatedMean - originalMean) << "\t"
+                << ks
+                << (pass ? "" : "\tFAIL") << "\n";
+    }
+
+  std::cout << "\nOriginal:  " << static_cast<double> (originalTime) / CLOCKS_PER_SEC << "s\n"
+            << "Tabulated: " << static_cast<double> (tabulatedTime) / CLOCKS_PER_SEC << "s\n";
+
+  std::cout << (ok ? "PASS" : "FAIL") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+#!/usr/bin/env python
+# -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+
+# Convert binary columnar trace (written by V2vTraceWriter) to tab-separated text,
+# the same as tracers write in text mode
+
+import sys
+import struct
+import argparse
+
+MAGIC = b"V2VTRACE"
+TRAILER_MARKER = 0xFFFFFFFF
+
+# type id: (struct format, size)
+TYPES = {
+    1: ("q", 8), # time, ns
+    2: ("B", 1),
+    3: ("I", 4),
+    4: ("q", 8),
+    5: ("f", 4),
+    6: ("d", 8),
+    }
+
+def read (f, fmt):
+    size = struct.calcsize (fmt)
+    data = f.read (size)
+    if len (data) != size:
+        raise IOError ("Truncated trace file")
+    return struct.unpack (fmt, data)
+
+def read_header (f):
+    if f.read (len (MAGIC)) != MAGIC:
+        raise IOError ("Not a V2V binary trace")
+    version, ncolumns = read (f, "<HB")
+    if version != 1:
+        raise IOError ("Unsupported trace version %d" % version)
+
+    columns = []
+    for i in range (ncolumns):
+        type, length = read (f, "<BB")
+        name = f.read (length).decode ("utf-8")
+        columns.append ((name, type))
+    return columns
+
+def blocks (f, columns):
+    "Iterate over blocks, yielding (count, offset of the block data); stops at the trailer"
+    row_size = sum (TYPES[type][1] for name, type in columns)
+    while True:
+        count, = read (f, "<I")
+        if count == TRAILER_MARKER:
+            return
+        offset = f.tell ()
+        yield count, offset
+        f.seek (offset + count * row_size)
+
+def read_labels (f):
+    labels = {}
+    nlabels, = read (f, "<I")
+    for i in range (nlabels):
+        column, value, length = read (f, "<BIH")
+        labels[(column, value)] = f.read (length).decode ("utf-8")
+    return labels
+
+def formatter (index, type, labels):
+    if type == 1:
+        return lambda value: ("%.9f" % (value / 1e9)).rstrip ("0").rstrip (".")
+    if type in (5, 6):
+        fmt = "%g" if type == 5 else "%.10g"
+        return lambda value: fmt % value
+    return lambda value: labels.get ((index, value), str (value))
+
+def convert (f, out):
+    columns = read_header (f)
+    start = f.tell ()
+
+    # labels are at the end of the file
+    for count, offset in blocks (f, columns):
+        pass
+    labels = read_labels (f)
+
+    formatters = [formatter (i, type, labels) for i, (name, type) in enumerate (columns)]
+    out.write ("\t".join (name for name, type in columns) + "\n")
+
+    f.seek (start)
+    for count, offset in blocks (f, columns):
+        values = []
+        for name, type in columns:
+            fmt, size = TYPES[type]
+            values.append (read (f, "<%d%s" % (count, fmt)))
+
+        for row in range (count):
+            out.write ("\t".join (formatters[i] (values[i][row]) for i in range (len (columns))) + "\n")
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser (description='Convert binary V2V trace to tab-separated text')
+    parser.add_argument ('input', type=str, help='Binary trace file')
+    parser.add_argument ('output', type=str, nargs='?', default='-', help='Output file (stdout by default)')
+    args = parser.parse_args ()
+
+    f_in = open (args.input, "rb")
+    f_out = sys.stdout if args.output == "-" else open (args.output, "w")
+    convert (f_in, f_out)
+    f_in.close ()
+    if f_out != sys.stdout:
+        f_out.close ()